@@ -0,0 +1,114 @@
+/**
+ * @file alloc_bench.cpp
+ * @brief Checks the heap allocations of the request path against budgets.
+ * @details An in-process server is sent pipelined batches of a command mix
+ *          and TCP_AllocTracker reports the allocations each command made,
+ *          from copying its line out of the receive buffer to appending its
+ *          reply. The program fails if a command allocates more per request
+ *          than its budget below, so a change that adds an allocation to
+ *          the hot path breaks `make bench`. When a command improves, lower
+ *          its budget to keep the gain.
+ *
+ *          Allocations are only counted in a tracking build:
+ *
+ *              make clean && make TRACK_ALLOCS=1 bench
+ *
+ *          In a normal build the check is skipped.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_alloc_tracker.hpp"
+#include "tcp_client.hpp"
+#include "tcp_server.hpp"
+
+// Standard includes
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief Port the benchmark server listens on.
+constexpr const int BENCH_PORT = 31493;
+
+/// @brief Pipelined batches sent, after one warm-up batch.
+constexpr const int ROUNDS = 200;
+
+/// @brief Server with a fast accept loop and no logging.
+using BenchServer = BasicTCPServer<TCP_EpollAccept, TCP_ThreadPerConnection, TCP_NullLog, TCP_Commands>;
+
+/// @brief Command lines of one batch.
+static const std::vector<std::string> MIX = {
+    "freq", "freq 7040100", "ppm", "version", "session",
+    "set bench.key value", "get bench.key", "incr bench.count",
+    "counter bench.hits", "bogus"};
+
+/// @brief Most allocations per request each command may make, as measured.
+static const std::map<std::string, double> BUDGET = {
+    {"freq", 0.5}, {"ppm", 1}, {"version", 0}, {"session", 4},
+    {"set", 2}, {"get", 0}, {"incr", 2}, {"counter", 2},
+    {"(unknown)", 0}};
+
+int main()
+{
+    if (!TCP_AllocTracker::enabled)
+    {
+        std::printf("Allocation tracking is off; run `make clean && make TRACK_ALLOCS=1 bench`.\n");
+        return 0;
+    }
+
+    TCP_Commands handler;
+    BenchServer server;
+    if (!server.start(BENCH_PORT, &handler))
+    {
+        std::printf("Unable to start server on port %d\n", BENCH_PORT);
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // The first batch creates keys and per-thread state; don't count it.
+    TCP_Client client("127.0.0.1", BENCH_PORT, 1);
+    std::vector<std::string> replies;
+    bool ok = client.requestBatch(MIX, replies);
+    TCP_AllocTracker::reset();
+    for (int i = 0; ok && i < ROUNDS; ++i)
+    {
+        ok = client.requestBatch(MIX, replies);
+    }
+    server.stop();
+    if (!ok)
+    {
+        std::printf("Lost the connection to the server\n");
+        return 1;
+    }
+
+    int failures = 0;
+    std::printf("%-12s %10s %14s %14s %8s\n", "command", "requests", "allocs/req", "bytes/req", "budget");
+    for (const auto &usage : TCP_AllocTracker::snapshot())
+    {
+        double allocs = static_cast<double>(usage.allocations) / usage.requests;
+        auto budget = BUDGET.find(usage.command);
+        const char *verdict = "";
+        if (budget == BUDGET.end())
+        {
+            verdict = "  no budget";
+            ++failures;
+        }
+        else if (allocs > budget->second)
+        {
+            verdict = "  OVER BUDGET";
+            ++failures;
+        }
+        std::printf("%-12s %10llu %14.2f %14llu %8.2f%s\n", usage.command.c_str(),
+                    static_cast<unsigned long long>(usage.requests), allocs,
+                    static_cast<unsigned long long>(usage.bytes / usage.requests),
+                    budget == BUDGET.end() ? 0.0 : budget->second, verdict);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file busy_poll_bench.cpp
+ * @brief Measures the latency gained and CPU spent by busy polling.
+ * @details Runs the same request/reply loop against an in-process server
+ *          using `TCP_EpollAccept` (block in the kernel) and
+ *          `TCP_BusyPollAccept` (spin, then park) and reports round-trip
+ *          percentiles next to the process CPU time per request. Requests
+ *          are sent back to back and after a short pause, which exceeds
+ *          the spin window and shows the parked case.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_client.hpp"
+#include "tcp_server.hpp"
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief Port the benchmark server listens on.
+constexpr const int BENCH_PORT = 31491;
+
+/// @brief Round trips per measurement.
+constexpr const int REQUESTS = 20000;
+
+/// @brief Pause between requests in the paced scenario.
+constexpr const auto PACE = std::chrono::microseconds(500);
+
+/// @brief Returns the CPU time consumed by the whole process.
+static double processCpuSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Times `count` requests and prints p50/p99 latency and CPU cost.
+ */
+static void measure(const char *label, TCP_Client &client, int count, std::chrono::microseconds pause)
+{
+    std::vector<double> latencies;
+    latencies.reserve(count);
+    std::string reply;
+    double cpu_begin = processCpuSeconds();
+    for (int i = 0; i < count; ++i)
+    {
+        if (pause.count() > 0)
+        {
+            std::this_thread::sleep_for(pause);
+        }
+        auto begin = std::chrono::steady_clock::now();
+        if (!client.request("freq", reply))
+        {
+            std::printf("%-30s request failed\n", label);
+            return;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+    }
+    double cpu = processCpuSeconds() - cpu_begin;
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%-30s p50 %7.1f us  p99 %7.1f us  cpu %7.1f us/request\n",
+                label, latencies[count / 2], latencies[count * 99 / 100], 1e6 * cpu / count);
+}
+
+/// @brief Benchmark server using the I/O policy `Io`.
+template <typename Io>
+using BenchServer = BasicTCPServer<Io, TCP_ThreadPerConnection, TCP_NullLog, TCP_Commands>;
+
+/**
+ * @brief Runs both scenarios against `server`.
+ * @return False if the server could not be started.
+ */
+template <typename Io>
+static bool run(const char *name, TCP_Commands &handler, BenchServer<Io> &server)
+{
+    if (!server.start(BENCH_PORT, &handler))
+    {
+        std::printf("Unable to start server on port %d\n", BENCH_PORT);
+        return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        TCP_Client client("127.0.0.1", BENCH_PORT, 1);
+        std::string label = std::string(name) + ", back to back";
+        measure(label.c_str(), client, REQUESTS, std::chrono::microseconds(0));
+        label = std::string(name) + ", paced";
+        measure(label.c_str(), client, REQUESTS / 10, PACE);
+    }
+    server.stop();
+    return true;
+}
+
+int main()
+{
+    TCP_Commands handler;
+    std::printf("Request latency and CPU cost, one connection, loopback:\n");
+    if (std::thread::hardware_concurrency() < 2)
+    {
+        std::printf("Note: one CPU; the spinning server competes with the client here.\n");
+    }
+
+    BenchServer<TCP_EpollAccept> blocking;
+    run("epoll", handler, blocking);
+
+    BenchServer<TCP_BusyPollAccept> spinning;
+    spinning.ioPolicy().setSpin(std::chrono::microseconds(200));
+    if (run("busy poll 200us", handler, spinning))
+    {
+        TCP_BusyPollStats stats = spinning.ioPolicy().stats();
+        std::printf("busy poll: %llu waits served spinning, %llu parked, %.1f ms spent spinning\n",
+                    static_cast<unsigned long long>(stats.hits),
+                    static_cast<unsigned long long>(stats.parks), stats.spin_ns / 1e6);
+    }
+    return 0;
+}
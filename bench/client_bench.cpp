@@ -0,0 +1,168 @@
+/**
+ * @file client_bench.cpp
+ * @brief Measures request throughput for each way of talking to the server.
+ * @details Starts an in-process server on `BENCH_PORT` and compares:
+ *          - a new connection per command, as `scripts/tcp_server_test.py`
+ *            does;
+ *          - `TCP_Client::request()` over a pooled persistent connection;
+ *          - `TCP_Client::requestBatch()` with `BATCH_SIZE` commands per
+ *            round trip;
+ *          - `TCP_Client::requestAsync()` from several threads at once.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_client.hpp"
+#include "tcp_server.hpp"
+
+// Standard includes
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+// System includes
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/// @brief Port the benchmark server listens on.
+constexpr const int BENCH_PORT = 31490;
+
+/// @brief Requests per measurement (the per-connection case uses fewer).
+constexpr const int REQUESTS = 20000;
+
+/// @brief Commands per requestBatch() call.
+constexpr const int BATCH_SIZE = 16;
+
+/// @brief Threads issuing asynchronous requests.
+constexpr const int ASYNC_THREADS = 8;
+
+/// @brief Server with a fast accept loop and no logging.
+using BenchServer = BasicTCPServer<TCP_EpollAccept, TCP_ThreadPerConnection, TCP_NullLog, TCP_Commands>;
+
+/**
+ * @brief Sends one command on a new connection and reads the reply.
+ */
+static bool requestOnce(const std::string &command, std::string &reply)
+{
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(BENCH_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        if (fd >= 0)
+            ::close(fd);
+        return false;
+    }
+    std::string line = command + "\n";
+    ::send(fd, line.data(), line.size(), MSG_NOSIGNAL);
+    reply.clear();
+    char buffer[1024];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    {
+        reply.append(buffer, static_cast<size_t>(n));
+        if (reply.back() == '\n')
+            break;
+    }
+    ::close(fd);
+    return n > 0;
+}
+
+/**
+ * @brief Runs `fn` (which performs `count` requests) and reports the rate.
+ */
+template <typename Fn>
+static void measure(const char *label, int count, Fn &&fn)
+{
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = fn();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    double us = std::chrono::duration<double, std::micro>(elapsed).count() / count;
+    std::printf("%-36s %8.1f us/request %10.0f requests/s%s\n",
+                label, us, 1e6 / us, ok ? "" : "  (FAILED)");
+}
+
+int main()
+{
+    TCP_Commands handler;
+    BenchServer server;
+    if (!server.start(BENCH_PORT, &handler))
+    {
+        std::printf("Unable to start server on port %d\n", BENCH_PORT);
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    TCP_Client client("127.0.0.1", BENCH_PORT, ASYNC_THREADS);
+    std::string reply;
+
+    std::printf("Client request paths, loopback:\n");
+    const int single = REQUESTS / 10;
+    measure("connection per command", single, [&]
+            {
+                for (int i = 0; i < single; ++i)
+                    if (!requestOnce("freq", reply))
+                        return false;
+                return true; });
+    measure("pooled request()", REQUESTS, [&]
+            {
+                for (int i = 0; i < REQUESTS; ++i)
+                    if (!client.request("freq", reply))
+                        return false;
+                return true; });
+    measure("requestBatch() x16", REQUESTS, [&]
+            {
+                std::vector<std::string> commands(BATCH_SIZE, "freq");
+                std::vector<std::string> replies;
+                for (int i = 0; i < REQUESTS; i += BATCH_SIZE)
+                    if (!client.requestBatch(commands, replies))
+                        return false;
+                return true; });
+    measure("requestAsync() x8 threads", REQUESTS, [&]
+            {
+                std::vector<std::future<bool>> workers;
+                for (int t = 0; t < ASYNC_THREADS; ++t)
+                {
+                    workers.push_back(std::async(std::launch::async, [&client]
+                                                 {
+                        // Keep several requests in flight per thread.
+                        std::vector<std::future<TCP_ClientResult>> inflight;
+                        bool ok = true;
+                        for (int i = 0; i < REQUESTS / ASYNC_THREADS; ++i)
+                        {
+                            inflight.push_back(client.requestAsync("freq"));
+                            if (inflight.size() == BATCH_SIZE)
+                            {
+                                for (auto &f : inflight)
+                                    ok = f.get().ok && ok;
+                                inflight.clear();
+                            }
+                        }
+                        for (auto &f : inflight)
+                            ok = f.get().ok && ok;
+                        return ok; }));
+                }
+                bool ok = true;
+                for (auto &w : workers)
+                    ok = w.get() && ok;
+                return ok; });
+
+    server.stop();
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file counter_bench.cpp
+ * @brief Measures concurrent increments of one counter.
+ * @details Several threads increment the same counter, first through
+ *          TCP_Counters (one shard per CPU) and then through a single
+ *          `std::atomic<int64_t>` that every core must own in turn.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_counters.hpp"
+
+// Standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief Increments per thread per measurement.
+constexpr const int INCREMENTS = 2000000;
+
+/**
+ * @brief Runs `fn` on `threads` threads and reports ns per increment.
+ */
+template <typename Fn>
+static void measure(const char *label, int threads, Fn fn)
+{
+    std::vector<std::thread> workers;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&fn]()
+                             {
+                                 for (int i = 0; i < INCREMENTS; ++i)
+                                     fn(); });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(INCREMENTS) * threads);
+    std::printf("%-24s %2d threads %8.1f ns/increment\n", label, threads, ns);
+}
+
+int main()
+{
+    TCP_Counters counters;
+    std::atomic<int64_t> shared{0};
+    const std::string name = "packets";
+
+    unsigned cpus = std::thread::hardware_concurrency();
+    int threads = cpus > 1 ? static_cast<int>(cpus) : 4;
+
+    std::printf("Concurrent increments of one counter:\n");
+    for (int n : {1, threads})
+    {
+        measure("TCP_Counters", n, [&]()
+                { counters.add(name, 1); });
+        measure("single std::atomic", n, [&]()
+                { shared.fetch_add(1, std::memory_order_relaxed); });
+    }
+
+    int64_t total = 0;
+    counters.read(name, total);
+    std::printf("Totals agree: %s\n", total == shared.load() ? "yes" : "no");
+    if (cpus < 2)
+        std::printf("Note: only %u CPU available; cache-line bouncing needs more cores.\n", cpus);
+    return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file flight_recorder_bench.cpp
+ * @brief Measures the cost of recording one request in the flight recorder.
+ * @details Each thread records begin()/finish() pairs for a typical command
+ *          and reports the nanoseconds per request, which is what every
+ *          command the server handles pays.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_flight_recorder.hpp"
+
+// Standard includes
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief Requests per thread per measurement.
+constexpr const int REQUESTS = 2000000;
+
+/**
+ * @brief Records REQUESTS requests on `threads` threads and reports ns each.
+ */
+static void measure(TCP_FlightRecorder &recorder, int threads)
+{
+    const std::string command = "freq";
+    const std::string arg = "7040100";
+    std::vector<std::thread> workers;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&recorder, &command, &arg, t]()
+                             {
+                                 for (int i = 0; i < REQUESTS; ++i)
+                                 {
+                                     auto *entry = recorder.begin(static_cast<uint64_t>(t), command, arg);
+                                     recorder.finish(entry, TCP_Status::OK);
+                                 } });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(REQUESTS) * threads);
+    std::printf("flight recorder %2d threads %8.1f ns/request\n", threads, ns);
+}
+
+int main()
+{
+    TCP_FlightRecorder recorder;
+    if (!recorder.open(""))
+    {
+        std::fprintf(stderr, "Unable to map the flight recorder\n");
+        return 1;
+    }
+    unsigned cpus = std::thread::hardware_concurrency();
+    measure(recorder, 1);
+    measure(recorder, cpus > 1 ? static_cast<int>(cpus) : 4);
+    return 0;
+}
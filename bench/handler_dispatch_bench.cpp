@@ -0,0 +1,157 @@
+/**
+ * @file handler_dispatch_bench.cpp
+ * @brief Measures the cost of command dispatch through each handler binding.
+ * @details Compares three ways of reaching a command handler method:
+ *          - the original chain: virtual `handleCommand()`, virtual
+ *            `processCommand()`, then a `std::function` from a map;
+ *          - `TCP_Commands` called through a `TCP_CommandHandler *`;
+ *          - `TCP_Commands` called directly, as `BasicTCPServer` does when
+ *            instantiated with it;
+ *          - the same with a session that negotiated the terse protocol,
+ *            also reporting the reply bytes per command in each format.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_command_handler.hpp"
+
+// Standard includes
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class LegacyCommands
+ * @brief Replica of the dispatch chain TCP_Commands used before CRTP.
+ */
+class LegacyCommands : public TCP_CommandHandler
+{
+public:
+    LegacyCommands()
+    {
+        // Same commands and parameter storage as TCP_Commands, so only the
+        // dispatch chain differs.
+        params.open("");
+        valid_commands = {
+            "transmit", "call", "grid", "power", "freq", "ppm", "selfcal",
+            "offset", "led", "port", "xmit", "version", "help"};
+        for (const auto &command : valid_commands)
+        {
+            command_handlers[command] = [this, command](const std::string &arg)
+            {
+                std::string value;
+                if (arg.empty())
+                    return params.get(command, value) ? command + " " + value : command + " <example response>";
+                return params.set(command, arg) ? command + " set to " + arg : "ERROR: Unable to store " + command + ".";
+            };
+        }
+    }
+
+    std::string handleCommand(const std::string &command, const std::string &arg) override
+    {
+        return processCommand(command, arg);
+    }
+
+    std::string processCommand(const std::string &command, const std::string &arg) override
+    {
+        auto it = command_handlers.find(command);
+        if (it != command_handlers.end())
+        {
+            return it->second(arg);
+        }
+        return "ERROR: Unknown command '" + command + "'. Type 'help' for a list of commands.";
+    }
+
+    const std::unordered_set<std::string> &getValidCommands() const override
+    {
+        return valid_commands;
+    }
+
+private:
+    std::unordered_set<std::string> valid_commands;
+    std::unordered_map<std::string, std::function<std::string(const std::string &)>> command_handlers;
+    TCP_ParamStore params;
+};
+
+/// @brief Number of dispatches per measurement.
+constexpr const int ITERATIONS = 2000000;
+
+/// @brief Prevents the compiler from discarding responses.
+static volatile std::size_t sink;
+
+/**
+ * @brief Runs `fn` over the request mix and reports nanoseconds per call.
+ */
+template <typename Fn>
+static double measure(const char *label, const std::vector<std::pair<std::string, std::string>> &requests, Fn &&fn)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        const auto &request = requests[i % requests.size()];
+        sink = sink + fn(request.first, request.second).size();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+    std::printf("%-36s %8.1f ns/call\n", label, ns);
+    return ns;
+}
+
+int main()
+{
+    const std::vector<std::pair<std::string, std::string>> requests = {
+        {"power", "5"}, {"freq", ""}, {"version", ""}, {"freq", "7040100"}};
+
+    // The server passes each connection's session.
+    TCP_Session text_session;
+    TCP_Session terse_session;
+    terse_session.protocol = TCP_Protocol::TERSE;
+
+    LegacyCommands legacy;
+    TCP_Commands commands;
+    TCP_CommandHandler *legacy_iface = &legacy;
+    TCP_CommandHandler *commands_iface = &commands;
+
+    std::printf("Handler dispatch, %d calls each:\n", ITERATIONS);
+    measure("warm-up", requests,
+            [&](const std::string &c, const std::string &a)
+            { return commands.handleCommand(c, a); });
+    double base = measure("legacy (virtual + std::function)", requests,
+                          [&](const std::string &c, const std::string &a)
+                          { return legacy_iface->handleCommand(c, a); });
+    double dyn = measure("TCP_Commands via interface", requests,
+                         [&](const std::string &c, const std::string &a)
+                         { return commands_iface->handleCommand(text_session, c, a); });
+    double stat = measure("TCP_Commands bound statically", requests,
+                          [&](const std::string &c, const std::string &a)
+                          { return commands.handleCommand(text_session, c, a); });
+
+    measure("TCP_Commands static, terse session", requests,
+            [&](const std::string &c, const std::string &a)
+            { return commands.handleCommand(terse_session, c, a); });
+
+    std::printf("Saving vs legacy: interface %.1f%%, static %.1f%%\n",
+                100.0 * (base - dyn) / base, 100.0 * (base - stat) / base);
+
+    std::size_t text_bytes = 0;
+    std::size_t terse_bytes = 0;
+    for (const auto &request : requests)
+    {
+        text_bytes += commands.handleCommand(text_session, request.first, request.second).size() + 1;
+        terse_bytes += commands.handleCommand(terse_session, request.first, request.second).size() + 1;
+    }
+    std::printf("Reply bytes per command: text %.1f, terse %.1f\n",
+                static_cast<double>(text_bytes) / requests.size(),
+                static_cast<double>(terse_bytes) / requests.size());
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file kv_store_bench.cpp
+ * @brief Measures TCP_KVStore against a mutex-guarded std::unordered_map.
+ * @details Each thread runs a mix of 90% `get` and 10% `set` over a shared
+ *          set of short keys, first against TCP_KVStore and then against
+ *          the obvious alternative: one `std::mutex` around an
+ *          `std::unordered_map<std::string, std::string>`.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_kv_store.hpp"
+
+// Standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Distinct keys in the working set.
+constexpr const int KEYS = 1024;
+
+/// @brief Operations per thread per measurement.
+constexpr const int OPERATIONS = 1000000;
+
+/// @brief Prevents the compiler from discarding reads.
+static std::atomic<std::size_t> sink{0};
+
+/**
+ * @class MapStore
+ * @brief The baseline: a single lock around a standard map.
+ */
+class MapStore
+{
+public:
+    bool set(const std::string &key, const std::string &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        map_[key] = value;
+        return true;
+    }
+
+    bool get(const std::string &key, std::string &value) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(key);
+        if (it == map_.end())
+            return false;
+        value = it->second;
+        return true;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::string> map_;
+};
+
+/**
+ * @brief Runs the get/set mix on `threads` threads and reports ns per operation.
+ */
+template <typename Store>
+static double measure(const char *label, Store &store, const std::vector<std::string> &keys, int threads)
+{
+    std::vector<std::thread> workers;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&store, &keys, t]()
+                             {
+                                 std::string value;
+                                 std::size_t found = 0;
+                                 for (int i = 0; i < OPERATIONS; ++i)
+                                 {
+                                     const std::string &key = keys[(i * 7 + t * 131) % KEYS];
+                                     if (i % 10 == 0)
+                                         store.set(key, "7040100");
+                                     else
+                                         found += store.get(key, value);
+                                 }
+                                 sink += found; });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(OPERATIONS) * threads);
+    std::printf("%-28s %2d threads %8.1f ns/op\n", label, threads, ns);
+    return ns;
+}
+
+int main()
+{
+    std::vector<std::string> keys;
+    for (int i = 0; i < KEYS; ++i)
+        keys.push_back("param" + std::to_string(i));
+
+    TCP_KVStore kv;
+    MapStore map;
+    for (const auto &key : keys)
+    {
+        kv.set(key, "0");
+        map.set(key, "0");
+    }
+
+    unsigned cpus = std::thread::hardware_concurrency();
+    std::printf("Key-value store, 90%% get / 10%% set over %d keys:\n", KEYS);
+    for (int threads : {1, 4})
+    {
+        measure("TCP_KVStore", kv, keys, threads);
+        measure("mutex + std::unordered_map", map, keys, threads);
+    }
+    if (cpus < 2)
+        std::printf("Note: only %u CPU available; contention effects need more cores.\n", cpus);
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file mutex_bench.cpp
+ * @brief Measures the overhead of TCP_Mutex over std::mutex.
+ * @details Threads take and release one lock around a tiny critical
+ *          section, first through `std::mutex` and then through TCP_Mutex,
+ *          then print what TCP_Mutex recorded.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_mutex.hpp"
+
+// Standard includes
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Lock acquisitions per thread per measurement.
+constexpr const int ACQUISITIONS = 2000000;
+
+/**
+ * @brief Locks `mutex` ACQUISITIONS times on `threads` threads; reports ns each.
+ */
+template <typename Mutex>
+static void measure(const char *label, Mutex &mutex, int threads)
+{
+    uint64_t shared = 0;
+    std::vector<std::thread> workers;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&mutex, &shared]()
+                             {
+                                 for (int i = 0; i < ACQUISITIONS; ++i)
+                                 {
+                                     std::lock_guard<Mutex> lock(mutex);
+                                     ++shared;
+                                 } });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(ACQUISITIONS) * threads);
+    std::printf("%-12s %2d threads %8.1f ns/acquisition\n", label, threads, ns);
+}
+
+int main()
+{
+    std::mutex plain;
+    TCP_Mutex instrumented("bench");
+
+    unsigned cpus = std::thread::hardware_concurrency();
+    int threads = cpus > 1 ? static_cast<int>(cpus) : 4;
+    for (int n : {1, threads})
+    {
+        measure("std::mutex", plain, n);
+        measure("TCP_Mutex", instrumented, n);
+    }
+
+    for (const TCP_Mutex::Report &report : TCP_Mutex::report())
+    {
+        std::printf("%s: %lld acquired, %lld contended, wait mean %llu ns, p99 %llu ns\n", report.name.c_str(),
+                    static_cast<long long>(report.acquisitions), static_cast<long long>(report.contended),
+                    static_cast<unsigned long long>(report.wait.mean()),
+                    static_cast<unsigned long long>(report.wait.percentile(0.99)));
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file socket_profile_bench.cpp
+ * @brief Measures the effect of each socket tuning profile on our workload.
+ * @details For every TCP_SocketProfile an in-process server is started and
+ *          three client patterns are timed:
+ *          - one-shot: connect, send one command, read the reply, close
+ *            (sent with `MSG_FASTOPEN`, so TFO is used when offered);
+ *          - interactive: one command at a time on a persistent connection;
+ *          - bulk: `BULK_BATCH` pipelined commands per round trip.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_client.hpp"
+#include "tcp_server.hpp"
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// System includes
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/// @brief Port the benchmark server listens on.
+constexpr const int BENCH_PORT = 31492;
+
+/// @brief One-shot connections per profile.
+constexpr const int ONE_SHOT = 1000;
+
+/// @brief Interactive round trips per profile.
+constexpr const int INTERACTIVE = 10000;
+
+/// @brief Commands per bulk round trip, and bulk round trips per profile.
+constexpr const int BULK_BATCH = 512;
+constexpr const int BULK_ROUNDS = 100;
+
+/// @brief Server with a fast accept loop and no logging.
+using BenchServer = BasicTCPServer<TCP_EpollAccept, TCP_ThreadPerConnection, TCP_NullLog, TCP_Commands>;
+
+/**
+ * @brief Sends one command on a new connection, using TFO if available.
+ */
+static bool requestOnce(const std::string &command)
+{
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(BENCH_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+    std::string line = command + "\n";
+    bool ok = ::sendto(fd, line.data(), line.size(), MSG_FASTOPEN | MSG_NOSIGNAL,
+                       reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) ==
+              static_cast<ssize_t>(line.size());
+    char buffer[256];
+    ssize_t n = ok ? ::recv(fd, buffer, sizeof(buffer), 0) : -1;
+    ::close(fd);
+    return n > 0;
+}
+
+/// @brief Returns the median of `samples` in microseconds.
+static double median(std::vector<double> &samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples.empty() ? 0 : samples[samples.size() / 2];
+}
+
+/// @brief Returns microseconds elapsed since `begin`.
+static double since(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main()
+{
+    TCP_Commands handler;
+    std::printf("Socket profiles, loopback (one-shot and interactive: median round trip):\n");
+    std::printf("%-12s %14s %14s %18s\n", "profile", "one-shot", "interactive", "bulk");
+
+    for (auto profile : {TCP_SocketProfile::DEFAULT, TCP_SocketProfile::LATENCY,
+                         TCP_SocketProfile::THROUGHPUT, TCP_SocketProfile::MEMORY})
+    {
+        BenchServer server;
+        if (!server.start(BENCH_PORT, &handler, nullptr, profile))
+        {
+            std::printf("Unable to start server on port %d\n", BENCH_PORT);
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        std::vector<double> samples;
+        for (int i = 0; i < ONE_SHOT; ++i)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            if (requestOnce("freq"))
+                samples.push_back(since(begin));
+        }
+        double one_shot = median(samples);
+
+        TCP_Client client("127.0.0.1", BENCH_PORT, 1);
+        std::string reply;
+        samples.clear();
+        for (int i = 0; i < INTERACTIVE; ++i)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            if (client.request("freq", reply))
+                samples.push_back(since(begin));
+        }
+        double interactive = median(samples);
+
+        std::vector<std::string> commands(BULK_BATCH, "freq");
+        std::vector<std::string> replies;
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < BULK_ROUNDS; ++i)
+            client.requestBatch(commands, replies);
+        double bulk = BULK_BATCH * BULK_ROUNDS / (since(begin) / 1e6);
+
+        std::printf("%-12s %11.1f us %11.1f us %10.0f cmd/s\n",
+                    TCP_SocketTuning::name(profile), one_shot, interactive, bulk);
+        server.stop();
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file stats_bench.cpp
+ * @brief Measures the server's per-request accounting.
+ * @details Several threads count "commands" and record a latency, first
+ *          through TCP_Stats (a shard per thread) and then through shared
+ *          `std::atomic` counters as the server used before.
+ *
+ *          Build and run with `make bench` from `src/`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_stats.hpp"
+
+// Standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/// @brief Updates per thread per measurement.
+constexpr const int UPDATES = 2000000;
+
+/**
+ * @brief Runs `fn` on `threads` threads and reports ns per update.
+ */
+template <typename Fn>
+static void measure(const char *label, int threads, Fn fn)
+{
+    std::vector<std::thread> workers;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&fn]()
+                             {
+                                 for (int i = 0; i < UPDATES; ++i)
+                                     fn(static_cast<uint64_t>(i)); });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(UPDATES) * threads);
+    std::printf("%-20s %2d threads %8.1f ns/update\n", label, threads, ns);
+}
+
+int main()
+{
+    TCP_Stats stats;
+    std::atomic<uint64_t> commands{0};
+    std::atomic<uint64_t> latency_sum{0};
+
+    unsigned cpus = std::thread::hardware_concurrency();
+    int threads = cpus > 1 ? static_cast<int>(cpus) : 4;
+
+    std::printf("Count a command and record its latency:\n");
+    for (int n : {1, threads})
+    {
+        measure("TCP_Stats", n, [&](uint64_t i)
+                { stats.add(0);
+                  stats.record(0, 500 + (i & 1023)); });
+        measure("shared std::atomic", n, [&](uint64_t i)
+                { commands.fetch_add(1, std::memory_order_relaxed);
+                  latency_sum.fetch_add(500 + (i & 1023), std::memory_order_relaxed); });
+    }
+
+    TCP_Stats::Histogram latency = stats.histogram(0);
+    std::printf("Totals agree: %s (p50 %llu ns, p99 %llu ns, %zu shards)\n",
+                static_cast<uint64_t>(stats.read(0)) == commands.load() && latency.sum == latency_sum.load() ? "yes" : "no",
+                static_cast<unsigned long long>(latency.percentile(0.50)),
+                static_cast<unsigned long long>(latency.percentile(0.99)), stats.shards());
+    if (cpus < 2)
+        std::printf("Note: only %u CPU available; cache-line bouncing needs more cores.\n", cpus);
+    return 0;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file example_plugin.cpp
+ * @brief Example command handler built as a TCP_PluginHandler plugin.
+ * @details Build with `make plugins` from `src/`, which writes
+ *          `build/bin/plugins/example_plugin.so`, and serve it with
+ *          `-P build/bin/plugins/example_plugin.so`. Rebuild with a
+ *          different `PLUGIN_VERSION` (e.g. `make plugins PLUGIN_VERSION=2`)
+ *          and send `plugin reload` or SIGHUP to swap it in.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+// Project includes
+#include "tcp_plugin_handler.hpp"
+
+// Standard includes
+#include <string>
+#include <unordered_set>
+
+#ifndef PLUGIN_VERSION
+#define PLUGIN_VERSION 1
+#endif
+
+/// @brief The plugin version as a string.
+#define PLUGIN_STRING(x) #x
+#define PLUGIN_VERSION_STRING(x) PLUGIN_STRING(x)
+
+/**
+ * @class ExamplePlugin
+ * @brief Answers `hello` and `version`.
+ */
+class ExamplePlugin : public TCP_CommandHandler
+{
+public:
+    std::string handleCommand(const std::string &command, const std::string &arg) override
+    {
+        return processCommand(command, arg);
+    }
+    using TCP_CommandHandler::handleCommand;
+
+    std::string processCommand(const std::string &command, const std::string &arg) override
+    {
+        if (command == "hello")
+            return "Hello " + (arg.empty() ? std::string("world") : arg) +
+                   " from plugin version " PLUGIN_VERSION_STRING(PLUGIN_VERSION);
+        if (command == "version")
+            return "Version " PLUGIN_VERSION_STRING(PLUGIN_VERSION);
+        return "ERROR: Unknown command '" + command + "'.";
+    }
+
+    const std::unordered_set<std::string> &getValidCommands() const override
+    {
+        static const std::unordered_set<std::string> commands = {"hello", "version"};
+        return commands;
+    }
+};
+
+TCP_PLUGIN_EXPORT(ExamplePlugin)
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+"""Decode a TCP-Server audit file (see src/tcp_audit_log.hpp).
+
+Usage: audit_decode.py FILE [-n COUNT] [--peer ADDR] [--command NAME]
+
+Prints one line per record, oldest first:
+    2025-06-01T12:00:00.123456Z session 3 127.0.0.1:50412 power 5 -> 0
+"""
+
+import argparse
+import datetime
+import struct
+import sys
+
+MAGIC = 0x5449445541504354  # "TCPAUDIT"
+LAYOUT = 1
+HEADER = struct.Struct("<QIIQQ")  # magic, layout, record_size, capacity, next
+HEADER_SIZE = 64
+RECORD = struct.Struct("<QqQHHI24s16s56s")
+FLAG_TRUNCATED = 1
+
+STATUS = {0: "OK", 1: "NO_VALUE", 10: "UNKNOWN_COMMAND", 11: "INVALID_ARGUMENT",
+          12: "LINE_TOO_LONG", 20: "STORE_FAILED"}
+
+
+def text(field):
+    """Return a NUL-padded field as a string."""
+    return field.split(b"\0", 1)[0].decode(errors="replace")
+
+
+def read_records(path):
+    """Return the completed records of an audit file in write order."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER_SIZE:
+        raise ValueError("file too short")
+    magic, layout, record_size, capacity, _ = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or layout != LAYOUT or record_size != RECORD.size:
+        raise ValueError("not an audit file of layout %d" % LAYOUT)
+
+    records = []
+    for i in range(capacity):
+        offset = HEADER_SIZE + i * RECORD.size
+        if offset + RECORD.size > len(data):
+            break
+        fields = RECORD.unpack_from(data, offset)
+        if fields[0] != 0:  # sequence 0: never written or being written
+            records.append(fields)
+    records.sort(key=lambda r: r[0])
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a TCP-Server audit file.")
+    parser.add_argument("file")
+    parser.add_argument("-n", type=int, default=0, help="show only the last N records")
+    parser.add_argument("--peer", help="show only records from this address")
+    parser.add_argument("--command", help="show only this command")
+    args = parser.parse_args()
+
+    try:
+        records = read_records(args.file)
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    lines = []
+    for _, time_ns, session, status, flags, _, peer, command, arg in records:
+        peer, command, arg = text(peer), text(command), text(arg)
+        if args.peer and peer.rsplit(":", 1)[0] != args.peer:
+            continue
+        if args.command and command != args.command:
+            continue
+        when = datetime.datetime.fromtimestamp(time_ns / 1e9, datetime.timezone.utc)
+        stamp = when.strftime("%Y-%m-%dT%H:%M:%S.%fZ")
+        if flags & FLAG_TRUNCATED:
+            arg += "..."
+        lines.append(f"{stamp} session {session} {peer or '-'} {command} {arg} -> "
+                     f"{STATUS.get(status, status)}")
+    for line in lines[-args.n if args.n > 0 else 0:]:
+        print(line)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+
+"""Decode a TCP-Server flight recorder file (see src/tcp_flight_recorder.hpp).
+
+Usage: flight_decode.py FILE [-n COUNT] [--in-flight]
+
+Prints the recorded requests of each thread, oldest first:
+    tid 4242 #17 2025-06-01T12:00:00.123456Z session 3    1850 ns OK freq 7040100
+A request whose handler never returned is marked IN FLIGHT; after a crash
+it is usually the one that crashed.
+"""
+
+import argparse
+import datetime
+import struct
+import sys
+
+MAGIC = 0x4847494C46504354  # "TCPFLIGH"
+LAYOUT = 1
+HEADER = struct.Struct("<QIIIIi")  # magic, layout, max_threads, ring_size, entry_size, pid
+HEADER_SIZE = 64
+RING = struct.Struct("<IIQ")  # owned, tid, head
+RING_HEADER_SIZE = 64
+ENTRY = struct.Struct("<QQqIHH16s80s")
+
+STATUS = {0: "OK", 1: "NO_VALUE", 10: "UNKNOWN_COMMAND", 11: "INVALID_ARGUMENT",
+          12: "LINE_TOO_LONG", 20: "STORE_FAILED"}
+
+
+def text(field):
+    """Return a NUL-padded field as a string."""
+    return field.split(b"\0", 1)[0].decode(errors="replace")
+
+
+def read_rings(path):
+    """Return (pid, [(tid, [entry fields...]), ...]) for every used ring."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER_SIZE:
+        raise ValueError("file too short")
+    magic, layout, max_threads, ring_size, entry_size, pid = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or layout != LAYOUT or entry_size != ENTRY.size:
+        raise ValueError("not a flight recorder file of layout %d" % LAYOUT)
+
+    ring_bytes = RING_HEADER_SIZE + ring_size * ENTRY.size
+    rings = []
+    for i in range(max_threads):
+        base = HEADER_SIZE + i * ring_bytes
+        if base + ring_bytes > len(data):
+            break
+        _, tid, head = RING.unpack_from(data, base)
+        if head == 0:
+            continue
+        entries = []
+        for sequence in range(max(1, head - ring_size + 1), head + 1):
+            offset = base + RING_HEADER_SIZE + ((sequence - 1) % ring_size) * ENTRY.size
+            fields = ENTRY.unpack_from(data, offset)
+            if fields[0] == sequence:  # otherwise half-written
+                entries.append(fields)
+        rings.append((tid, entries))
+    return pid, rings
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a TCP-Server flight recorder file.")
+    parser.add_argument("file")
+    parser.add_argument("-n", type=int, default=0, help="show only the last N requests per thread")
+    parser.add_argument("--in-flight", action="store_true",
+                        help="show only requests whose handler never returned")
+    args = parser.parse_args()
+
+    try:
+        pid, rings = read_rings(args.file)
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    print(f"pid {pid}, {len(rings)} thread(s)")
+    for tid, entries in rings:
+        lines = []
+        for sequence, session, start_ns, handler_ns, status, done, command, arg in entries:
+            if args.in_flight and done:
+                continue
+            when = datetime.datetime.fromtimestamp(start_ns / 1e9, datetime.timezone.utc)
+            stamp = when.strftime("%Y-%m-%dT%H:%M:%S.%fZ")
+            result = f"{handler_ns:7d} ns {STATUS.get(status, status)}" if done else "IN FLIGHT"
+            line = f"tid {tid} #{sequence} {stamp} session {session} {result} {text(command)}"
+            lines.append(f"{line} {text(arg)}" if text(arg) else line)
+        for line in lines[-args.n if args.n > 0 else 0:]:
+            print(line)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
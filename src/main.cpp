@@ -13,21 +13,47 @@
 
 // Project includes
 #include "tcp_server.hpp"
+#include "tcp_alloc_tracker.hpp"
+#include "tcp_command_costs.hpp"
 #include "tcp_command_handler.hpp"
+#include "tcp_flight_recorder.hpp"
+#include "tcp_mutex.hpp"
+#include "tcp_plugin_handler.hpp"
+#include "tcp_prefork.hpp"
+#include "tcp_proxy_handler.hpp"
+#include "tcp_replication.hpp"
 
 // Standard includes
 #include <atomic>
+#include <chrono>
 #include <csignal>
+#include <ctime>
 #include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <mutex>
 #include <queue>
 #include <string>
 #include <thread>
+#include <vector>
+
+// System includes
+#include <unistd.h>
 
 /// @brief Port number for the TCP server.
 constexpr const int SERVERPORT = 31415;
 
+/// @brief Default shared-memory object holding parameter values, as
+///        prefix + port + suffix, so servers on different ports never
+///        share (or overwrite) each other's parameters.
+constexpr const char *PARAM_STORE_PREFIX = "/tcp-server.";
+constexpr const char *PARAM_STORE_SUFFIX = ".params";
+
+/// @brief Records kept in the audit file (8 MiB).
+constexpr const std::size_t AUDIT_RECORDS = 65536;
+
 /// @brief Atomic flag to indicate whether the server is running.
 std::atomic<bool> running(true);
 
@@ -35,23 +61,56 @@ std::atomic<bool> running(true);
 TCP_Server server;
 TCP_Commands handler;
 
-// Global condition variable and mutex for waiting until the server stops.
-std::mutex cv_mutex;
-std::condition_variable cv;
+/// @brief Handler used instead of `handler` in proxy mode.
+TCP_ProxyHandler proxy;
+
+/// @brief Handler used instead of `handler` when serving a plugin.
+TCP_PluginHandler plugins;
+
+/// @brief Last requests of every server thread, dumped on a crash.
+TCP_FlightRecorder recorder;
+
+/// @brief Handler CPU time per command, filled when run with `-C`.
+TCP_CommandCosts costs;
+
+/// @brief Set by SIGHUP; the plugin is reloaded by the main loop.
+std::atomic<bool> reload_requested(false);
 
-// A simple asynchronous logger.
+/// @brief Set by SIGUSR1; a following replica is promoted by the main loop.
+std::atomic<bool> promote_requested(false);
+
+/// @brief Set by SIGINT and SIGTERM; the server is stopped by the main loop.
+std::atomic<bool> stop_requested(false);
+
+/// @brief How often the main loop checks the signal flags.
+constexpr const auto SIGNAL_POLL_INTERVAL = std::chrono::milliseconds(100);
+
+/// @brief Prefork supervisor, set only in the supervisor process.
+TCP_Prefork *gPrefork = nullptr;
+
+/// @brief Replication endpoints; at most one is started.
+TCP_ReplicationPrimary gPrimary;
+TCP_ReplicationReplica gReplica;
+
+// A simple asynchronous logger. The worker thread is started explicitly so
+// that a prefork supervisor can fork before any thread exists.
 class AsyncLogger
 {
 public:
-    AsyncLogger() : stopFlag(false)
+    AsyncLogger() : queueMutex("logger"), stopFlag(false) {}
+
+    void start()
     {
-        workerThread = std::thread(&AsyncLogger::worker, this);
+        if (!workerThread.joinable())
+        {
+            workerThread = std::thread(&AsyncLogger::worker, this);
+        }
     }
 
     ~AsyncLogger()
     {
         {
-            std::lock_guard<std::mutex> lock(queueMutex);
+            std::lock_guard<TCP_Mutex> lock(queueMutex);
             stopFlag = true;
         }
         cv.notify_all();
@@ -65,7 +124,7 @@ public:
     void log(const std::string &msg)
     {
         {
-            std::lock_guard<std::mutex> lock(queueMutex);
+            std::lock_guard<TCP_Mutex> lock(queueMutex);
             messageQueue.push(msg);
         }
         cv.notify_one();
@@ -73,8 +132,8 @@ public:
 
 private:
     std::queue<std::string> messageQueue;
-    std::mutex queueMutex;
-    std::condition_variable cv;
+    TCP_Mutex queueMutex;
+    std::condition_variable_any cv;
     bool stopFlag;
     std::thread workerThread;
 
@@ -85,7 +144,7 @@ private:
         {
             std::string msg;
             {
-                std::unique_lock<std::mutex> lock(queueMutex);
+                std::unique_lock<TCP_Mutex> lock(queueMutex);
                 cv.wait(lock, [this]
                         { return !messageQueue.empty() || stopFlag; });
                 if (stopFlag && messageQueue.empty())
@@ -103,8 +162,10 @@ private:
 AsyncLogger gLogger;
 
 /**
- * @brief Signal handler to gracefully stop the server.
- * @details Captures SIGINT and SIGTERM to ensure a clean shutdown.
+ * @brief Signal handler requesting a graceful stop.
+ * @details Only sets a flag: stopping the server locks mutexes and joins
+ *          threads, which is not async-signal-safe and would deadlock or
+ *          join itself if the signal landed on a server thread.
  *
  * @param signal The signal number received (SIGINT, SIGTERM).
  */
@@ -112,76 +173,541 @@ void signalHandler(int signal)
 {
     if (signal == SIGINT || signal == SIGTERM)
     {
-        if (server.isRunning())
-        {
-            server.stop(); // Ensure clean shutdown on Ctrl+C or SIGTERM.
-        }
-        // Notify the condition variable so main() can wake up.
-        cv.notify_all();
+        stop_requested = true;
     }
 }
 
 /**
- * @brief Callback function for the TCP server.
+ * @brief Signal handler requesting a plugin reload.
  *
- * Converts the provided Priority enum into a string and enqueues the full message
- * for asynchronous printing.
+ * @param signal The signal number received (SIGHUP).
+ */
+void reloadSignalHandler(int signal)
+{
+    if (signal == SIGHUP)
+    {
+        reload_requested = true;
+    }
+}
+
+/**
+ * @brief Signal handler requesting promotion of a replica.
+ *
+ * @param signal The signal number received (SIGUSR1).
+ */
+void promoteSignalHandler(int signal)
+{
+    if (signal == SIGUSR1)
+    {
+        promote_requested = true;
+    }
+}
+
+/**
+ * @brief Signal handler for crashes.
+ * @details Writes the flight recorder to stderr, then lets the signal's
+ *          default action terminate the process (and dump core).
+ *
+ * @param signal The signal number received (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT).
+ */
+void crashSignalHandler(int signal)
+{
+    static const char banner[] = "Fatal signal, recent requests:\n";
+    ssize_t written = write(STDERR_FILENO, banner, sizeof(banner) - 1);
+    (void)written;
+    recorder.dump(STDERR_FILENO);
+    std::signal(signal, SIG_DFL);
+    raise(signal);
+}
+
+/**
+ * @brief Signal handler for the prefork supervisor.
+ * @details Asks the supervisor to stop; it then terminates the workers.
+ *
+ * @param signal The signal number received (SIGINT, SIGTERM).
+ */
+void supervisorSignalHandler(int signal)
+{
+    if ((signal == SIGINT || signal == SIGTERM) && gPrefork != nullptr)
+    {
+        gPrefork->requestStop();
+    }
+}
+
+/**
+ * @brief Converts a server priority to its fixed-width log label.
  *
  * @param priority The priority level.
- * @param msg The message to print.
- * @param success Whether the operation succeeded.
+ * @return The five-character label.
  */
-void callback_tcp_server(TCP_Server::Priority priority, const std::string &msg, bool success)
+std::string priorityLabel(TCP_Server::Priority priority)
 {
-    std::string priorityStr;
     switch (priority)
     {
     case TCP_Server::Priority::DEBUG:
-        priorityStr = "DEBUG";
-        break;
+        return "DEBUG";
     case TCP_Server::Priority::INFO:
-        priorityStr = "INFO ";
-        break;
+        return "INFO ";
     case TCP_Server::Priority::WARN:
-        priorityStr = "WARN ";
-        break;
+        return "WARN ";
     case TCP_Server::Priority::ERROR:
-        priorityStr = "ERROR";
-        break;
+        return "ERROR";
     case TCP_Server::Priority::FATAL:
-        priorityStr = "FATAL";
-        break;
+        return "FATAL";
     default:
-        priorityStr = "UNKWN";
-        break;
+        return "UNKWN";
     }
+}
+
+/**
+ * @brief Callback function for the TCP server.
+ *
+ * Converts the provided Priority enum into a string and enqueues the full message
+ * for asynchronous printing.
+ *
+ * @param priority The priority level.
+ * @param msg The message to print.
+ * @param success Whether the operation succeeded.
+ */
+void callback_tcp_server(TCP_Server::Priority priority, const std::string &msg, bool success)
+{
+    std::string priorityStr = priorityLabel(priority);
     std::string fullMsg = "[" + priorityStr + "] TCPSERVER: " + msg;
     gLogger.log(fullMsg);
 }
 
 /**
- * @brief Entry point for the TCP server.
- * @details Initializes logging, creates a TCP server instance, and handles
- *          signal-based shutdown while waiting on a condition variable.
+ * @brief Callback function for replication events.
  *
- * @return Returns 0 on successful execution, or 1 on failure.
+ * @param priority The priority level.
+ * @param msg The message to print.
+ * @param success Whether the operation succeeded.
+ */
+void callback_replication(TCP_Server::Priority priority, const std::string &msg, bool success)
+{
+    gLogger.log("[" + priorityLabel(priority) + "] REPLICATION: " + msg);
+}
+
+/**
+ * @brief Reads the admin token from the first line of a file.
+ * @details A file keeps the token out of the process list.
+ *
+ * @param path The token file.
+ * @param token Receives the token, without surrounding whitespace.
+ * @return True if a non-empty token was read.
+ */
+bool readToken(const std::string &path, std::string &token)
+{
+    std::ifstream file(path);
+    if (!std::getline(file, token))
+    {
+        return false;
+    }
+    token.erase(token.find_last_not_of(" \t\r") + 1);
+    token.erase(0, token.find_first_not_of(" \t"));
+    return !token.empty();
+}
+
+/**
+ * @brief Splits "[host:]port" into its parts.
+ *
+ * @param endpoint The endpoint string.
+ * @param host Receives the host, unchanged if the endpoint has none.
+ * @param port Receives the port.
+ * @return True if a port was found.
+ */
+bool parseEndpoint(const std::string &endpoint, std::string &host, int &port)
+{
+    size_t colon = endpoint.rfind(':');
+    if (colon != std::string::npos)
+    {
+        host = endpoint.substr(0, colon);
+    }
+    port = std::atoi(endpoint.c_str() + (colon == std::string::npos ? 0 : colon + 1));
+    return port > 0;
+}
+
+/**
+ * @brief Callback function for the prefork supervisor.
+ * @details The supervisor is single-threaded and forks repeatedly, so it
+ *          writes directly instead of through the asynchronous logger.
+ *
+ * @param priority The priority level.
+ * @param msg The message to print.
+ * @param success Whether the operation succeeded.
+ */
+void callback_supervisor(TCP_Server::Priority priority, const std::string &msg, bool success)
+{
+    std::cout << "[" + priorityLabel(priority) + "] PREFORK: " + msg << std::endl;
+}
+
+/**
+ * @brief Formats this process's statistics for the `stats` command.
+ * @details `stats` reports the server's activity, `stats locks` every
+ *          TCP_Mutex name and `stats commands` the handler cost of each
+ *          command (with `-C`).
+ *
+ * @param section Empty, "locks" or "commands".
+ * @return Space-separated `name=value` pairs, empty for an unknown section.
+ */
+std::string serverStats(const std::string &section)
+{
+    if (section == "locks")
+    {
+        std::string reply = "pid=" + std::to_string(getpid());
+        for (const TCP_Mutex::Report &lock : TCP_Mutex::report())
+        {
+            reply += " " + lock.name + ".acquired=" + std::to_string(lock.acquisitions) +
+                     " " + lock.name + ".contended=" + std::to_string(lock.contended) +
+                     " " + lock.name + ".wait_ns_mean=" + std::to_string(lock.wait.mean()) +
+                     " " + lock.name + ".wait_ns_p99=" + std::to_string(lock.wait.percentile(0.99));
+        }
+        return reply;
+    }
+    if (section == "commands")
+    {
+        std::vector<TCP_CommandCosts::Cost> commands = costs.snapshot();
+        uint64_t total_cpu = 0;
+        for (const auto &cost : commands)
+        {
+            total_cpu += cost.cpu_ns;
+        }
+        struct timespec process;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &process);
+        std::string reply = "pid=" + std::to_string(getpid()) +
+                            " handler_cpu_ns=" + std::to_string(total_cpu) +
+                            " process_cpu_ns=" + std::to_string(process.tv_sec * 1000000000LL + process.tv_nsec);
+        char share[32];
+        for (const auto &cost : commands)
+        {
+            std::snprintf(share, sizeof(share), "%.3f", total_cpu ? static_cast<double>(cost.cpu_ns) / total_cpu : 0.0);
+            reply += " " + cost.command + ".requests=" + std::to_string(cost.requests) +
+                     " " + cost.command + ".cpu_ns_mean=" + std::to_string(cost.cpu_ns / cost.requests) +
+                     " " + cost.command + ".wall_ns_mean=" + std::to_string(cost.wall_ns / cost.requests) +
+                     " " + cost.command + ".cpu_share=" + share;
+        }
+        return reply;
+    }
+    if (section == "allocs")
+    {
+        std::string reply = "pid=" + std::to_string(getpid()) +
+                            " tracking=" + (TCP_AllocTracker::enabled ? "on" : "off");
+        char per_request[32];
+        for (const auto &usage : TCP_AllocTracker::snapshot())
+        {
+            std::snprintf(per_request, sizeof(per_request), "%.2f",
+                          static_cast<double>(usage.allocations) / usage.requests);
+            reply += " " + usage.command + ".requests=" + std::to_string(usage.requests) +
+                     " " + usage.command + ".allocs_per_request=" + per_request +
+                     " " + usage.command + ".bytes_per_request=" + std::to_string(usage.bytes / usage.requests);
+        }
+        return reply;
+    }
+    if (!section.empty())
+    {
+        return std::string();
+    }
+    TCP_ServerStats totals = server.getStats();
+    TCP_Stats::Histogram latency = server.stats().histogram(STAT_COMMAND_NS);
+    return "pid=" + std::to_string(getpid()) +
+           " connections=" + std::to_string(totals.connections) +
+           " commands=" + std::to_string(totals.commands) +
+           " active=" + std::to_string(totals.active) +
+           " command_ns_mean=" + std::to_string(latency.mean()) +
+           " command_ns_p50=" + std::to_string(latency.percentile(0.50)) +
+           " command_ns_p99=" + std::to_string(latency.percentile(0.99)) +
+           " shards=" + std::to_string(server.stats().shards());
+}
+
+/**
+ * @brief Runs the TCP server until a shutdown signal is received.
+ * @details The server is stopped here, not in the signal handler. When
+ *          `slot` is given (prefork worker), the server counters are
+ *          published into shared memory once per second.
+ *
+ * @param port The port to listen on.
+ * @param command_handler The handler to serve.
+ * @param profile Socket tuning profile.
+ * @param slot The worker's shared-memory slot, or nullptr.
+ * @param flight Flight recorder file, or empty for anonymous memory.
+ * @return 0 on a clean stop, 1 if the server failed to start.
  */
-int main()
+int runServer(int port, TCP_CommandHandler *command_handler, TCP_SocketProfile profile, TCP_WorkerSlot *slot,
+              const std::string &flight)
 {
     // Register signal handlers for graceful shutdown.
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+    std::signal(SIGHUP, reloadSignalHandler);
+    std::signal(SIGUSR1, promoteSignalHandler);
+    gLogger.start();
+
+    // Keep the last requests of each thread for post-mortem analysis.
+    if (recorder.open(flight))
+    {
+        server.setFlightRecorder(&recorder);
+        for (int crash : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT})
+        {
+            std::signal(crash, crashSignalHandler);
+        }
+    }
+    else
+    {
+        gLogger.log("[WARN ] FLIGHT: Unable to open flight recorder " + flight);
+    }
 
     // Start the TCP server with our callback.
     // server.start(SERVERPORT, &handler);
-    server.start(SERVERPORT, &handler, callback_tcp_server);
+    if (!server.start(port, command_handler, callback_tcp_server, profile))
+    {
+        return 1;
+    }
     server.setPriority(SCHED_RR, 10);
 
-    // Wait for the server to stop using a condition variable.
-    std::unique_lock<std::mutex> lock(cv_mutex);
-    cv.wait(lock, []
-            { return !server.isRunning(); });
-
-    gLogger.log("Exiting main.");
+    // Poll the signal flags until the server stops or a stop is requested.
+    auto next_publish = std::chrono::steady_clock::now();
+    while (server.isRunning() && !stop_requested.load())
+    {
+        std::this_thread::sleep_for(SIGNAL_POLL_INTERVAL);
+        if (slot != nullptr && std::chrono::steady_clock::now() >= next_publish)
+        {
+            slot->publish(server.getStats());
+            next_publish += std::chrono::seconds(1);
+        }
+        if (reload_requested.exchange(false) && command_handler == &plugins)
+        {
+            std::string error;
+            if (plugins.reload(error))
+                gLogger.log("[INFO ] PLUGIN: Loaded generation " + std::to_string(plugins.generation()) + ".");
+            else
+                gLogger.log("[ERROR] PLUGIN: " + error);
+        }
+        if (promote_requested.exchange(false) && gReplica.isRunning())
+        {
+            // Stop following first so no late change lands after local sets.
+            gReplica.stop();
+            handler.setParametersReadOnly(false);
+            gLogger.log("[INFO ] REPLICATION: Promoted to primary at sequence " + std::to_string(gReplica.sequence()) + ".");
+        }
+    }
+    server.stop();
+    if (slot != nullptr)
+    {
+        slot->publish(server.getStats());
+    }
     return 0;
 }
+
+/**
+ * @brief Entry point for the TCP server.
+ * @details Parses options, then either runs a single server or a prefork
+ *          supervisor with `-w N` worker processes sharing the port.
+ *
+ *          Options:
+ *          - `-p PORT` Port to listen on (default 31415).
+ *          - `-w N`    Run N prefork worker processes.
+ *          - `-s NAME` Shared-memory parameter store (default
+ *                      `/tcp-server.PORT.params`, `-s ""` for a private
+ *                      store).
+ *          - `-r [ADDR:]PORT` Act as replication primary on PORT.
+ *          - `-f HOST:PORT`   Follow (replicate) the primary at HOST:PORT;
+ *                             SIGUSR1 stops following and accepts sets.
+ *          - `-x LIST` Proxy to backends, LIST is `name=host:port,...`.
+ *          - `-t NAME` Socket profile: default, latency, throughput, memory.
+ *          - `-a FILE` Audit parameter changes to FILE (see TCP_AuditLog).
+ *          - `-C`      Measure the handler CPU time of each command for
+ *                      `stats commands`.
+ *          - `-F FILE` Keep the flight recorder in FILE (FILE.PID per
+ *                      prefork worker) instead of anonymous memory.
+ *          - `-o DIR`  Write `profile` output to DIR (default `/tmp`).
+ *          - `-k FILE` Read the admin token from FILE. `auth <token>`
+ *                      then unlocks `profile`, `macro define|delete` and
+ *                      `plugin reload`, which are disabled without it.
+ *          - `-P FILE` Serve the handler plugin FILE; SIGHUP reloads it.
+ *          - `-H N`    Keep the last N values of freq, ppm and power for
+ *                      the `history` command.
+ *
+ * @return Returns 0 on successful execution, or 1 on failure.
+ */
+int main(int argc, char *argv[])
+{
+    int port = SERVERPORT;
+    int workers = 0;
+    std::string store;
+    bool store_given = false;
+    std::string replicate;
+    std::string follow;
+    TCP_CommandHandler *command_handler = &handler;
+    TCP_SocketProfile profile = TCP_SocketProfile::DEFAULT;
+    int history = 0;
+    std::string audit;
+    std::string flight;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:w:s:r:f:x:t:H:P:a:F:Co:k:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            port = std::atoi(optarg);
+            break;
+        case 'w':
+            workers = std::atoi(optarg);
+            break;
+        case 's':
+            store = optarg;
+            store_given = true;
+            break;
+        case 'r':
+            replicate = optarg;
+            break;
+        case 'f':
+            follow = optarg;
+            break;
+        case 'x':
+            if (!proxy.addBackends(optarg))
+            {
+                std::cerr << "Invalid backend list: " << optarg << std::endl;
+                return 1;
+            }
+            command_handler = &proxy;
+            break;
+        case 't':
+            if (!TCP_SocketTuning::parse(optarg, profile))
+            {
+                std::cerr << "Unknown socket profile: " << optarg << std::endl;
+                return 1;
+            }
+            break;
+        case 'P':
+        {
+            std::string error;
+            if (!plugins.load(optarg, error))
+            {
+                std::cerr << "Unable to load plugin: " << error << std::endl;
+                return 1;
+            }
+            command_handler = &plugins;
+            break;
+        }
+        case 'a':
+            audit = optarg;
+            break;
+        case 'C':
+            server.setCommandCosts(&costs);
+            break;
+        case 'F':
+            flight = optarg;
+            break;
+        case 'o':
+            handler.setProfileDirectory(optarg);
+            break;
+        case 'k':
+        {
+            std::string token;
+            if (!readToken(optarg, token))
+            {
+                std::cerr << "Unable to read an admin token from " << optarg << std::endl;
+                return 1;
+            }
+            handler.setAdminToken(token);
+            plugins.setAdminToken(token);
+            break;
+        }
+        case 'H':
+            history = std::atoi(optarg);
+            break;
+        default:
+            std::cerr << "Usage: " << argv[0]
+                      << " [-p port] [-w workers] [-s store] [-r [addr:]port | -f host:port]"
+                      << " [-x name=host:port,...] [-t default|latency|throughput|memory]"
+                      << " [-H samples] [-P plugin.so] [-a audit-file] [-F flight-file] [-C]"
+                      << " [-o profile-dir] [-k token-file]" << std::endl;
+            return 1;
+        }
+    }
+    if (!store_given)
+    {
+        store = PARAM_STORE_PREFIX + std::to_string(port) + PARAM_STORE_SUFFIX;
+    }
+    if (workers > 0 && (!replicate.empty() || !follow.empty()))
+    {
+        std::cerr << "Replication is only supported in single-process mode." << std::endl;
+        return 1;
+    }
+
+    // Share parameter values with other processes (and prefork workers).
+    if (!store.empty() && !handler.attachStore(store))
+    {
+        std::cerr << "Unable to attach parameter store " << store << ", using a private store." << std::endl;
+    }
+
+    // Open the audit file before forking so workers share one ring.
+    if (!audit.empty() && !handler.attachAuditLog(audit, AUDIT_RECORDS))
+    {
+        std::cerr << "Unable to open audit file " << audit << std::endl;
+        return 1;
+    }
+
+    handler.setStatsReporter(serverStats);
+
+    // Record the parameters dashboards plot.
+    if (history > 0)
+    {
+        for (const char *key : {"freq", "ppm", "power"})
+        {
+            handler.enableHistory(key, static_cast<std::size_t>(history));
+        }
+    }
+
+    if (workers <= 0)
+    {
+        std::string host = "127.0.0.1";
+        int repl_port = 0;
+        if (!replicate.empty())
+        {
+            if (!parseEndpoint(replicate, host, repl_port) ||
+                !gPrimary.start(repl_port, &handler.parameters(), host, callback_replication))
+            {
+                std::cerr << "Unable to start replication primary on " << replicate << std::endl;
+                return 1;
+            }
+            handler.setChangeListener([](const std::string &key, const std::string &value)
+                                      { gPrimary.publish(key, value); });
+        }
+        else if (!follow.empty())
+        {
+            if (!parseEndpoint(follow, host, repl_port) ||
+                !gReplica.start(host, repl_port, &handler.parameters(), callback_replication))
+            {
+                std::cerr << "Unable to follow primary " << follow << std::endl;
+                return 1;
+            }
+            handler.setParametersReadOnly(true);
+        }
+
+        int result = runServer(port, command_handler, profile, nullptr, flight);
+        gReplica.stop();
+        gPrimary.stop();
+        gLogger.log("Exiting main.");
+        return result;
+    }
+
+    // Prefork: the supervisor forks before any thread is started.
+    TCP_Prefork prefork(workers, callback_supervisor);
+    gPrefork = &prefork;
+    std::signal(SIGINT, supervisorSignalHandler);
+    std::signal(SIGTERM, supervisorSignalHandler);
+    // Workers reload their plugin on SIGHUP; signal the process group.
+    std::signal(SIGHUP, SIG_IGN);
+
+    int result = prefork.run([port, command_handler, profile, flight](int, TCP_WorkerSlot &slot)
+                             {
+                                 // A replacement worker must not overwrite the file of the one that crashed.
+                                 std::string file = flight.empty() ? flight : flight + "." + std::to_string(getpid());
+                                 int code = runServer(port, command_handler, profile, &slot, file);
+                                 gLogger.log("Exiting worker.");
+                                 return code; });
+    gPrefork = nullptr;
+    return result;
+}
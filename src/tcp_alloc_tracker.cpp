@@ -0,0 +1,212 @@
+/**
+ * @file tcp_alloc_tracker.cpp
+ * @brief Implementation of the request path allocation counting.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_alloc_tracker.hpp"
+
+// Project includes
+#include "tcp_mutex.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+
+/**
+ * @struct AllocState
+ * @brief The calling thread's open scope.
+ * @details Plain data, so the thread-local needs no constructor and is
+ *          safe to use from operator new at any time.
+ */
+struct AllocState
+{
+    bool counting;
+    uint64_t allocations;
+    uint64_t bytes;
+    std::size_t name_size;
+    char name[TCP_AllocTracker::NAME_SIZE];
+};
+
+static thread_local AllocState alloc_state;
+
+/// @brief Serializes the totals; leaked so it outlives static destructors.
+static TCP_Mutex &totalsMutex()
+{
+    static TCP_Mutex *mutex = new TCP_Mutex("allocs");
+    return *mutex;
+}
+
+/// @brief Totals by command name; leaked with the mutex.
+static std::unordered_map<std::string, TCP_AllocTracker::Usage> &totals()
+{
+    static auto *table = new std::unordered_map<std::string, TCP_AllocTracker::Usage>();
+    return *table;
+}
+
+bool TCP_AllocTracker::start()
+{
+    AllocState &state = alloc_state;
+    if (state.counting)
+    {
+        return false;
+    }
+    state.allocations = 0;
+    state.bytes = 0;
+    state.name_size = 0;
+    state.counting = true;
+    return true;
+}
+
+void TCP_AllocTracker::stop()
+{
+    AllocState &state = alloc_state;
+    state.counting = false;
+    if (state.name_size == 0)
+    {
+        return;
+    }
+
+    // Counting is off: what this allocates is not charged to the command.
+    std::string command(state.name, state.name_size);
+    std::lock_guard<TCP_Mutex> lock(totalsMutex());
+    Usage &usage = totals()[command];
+    if (usage.command.empty())
+    {
+        usage.command = command;
+    }
+    ++usage.requests;
+    usage.allocations += state.allocations;
+    usage.bytes += state.bytes;
+}
+
+void TCP_AllocTracker::setName(const char *command, std::size_t size)
+{
+    AllocState &state = alloc_state;
+    if (!state.counting)
+    {
+        return;
+    }
+    state.name_size = std::min(size, NAME_SIZE);
+    std::memcpy(state.name, command, state.name_size);
+}
+
+/**
+ * @brief Reads every command's totals.
+ * @return One entry per command, most allocations per request first.
+ */
+std::vector<TCP_AllocTracker::Usage> TCP_AllocTracker::snapshot()
+{
+    std::vector<Usage> usages;
+    {
+        std::lock_guard<TCP_Mutex> lock(totalsMutex());
+        usages.reserve(totals().size());
+        for (const auto &entry : totals())
+        {
+            usages.push_back(entry.second);
+        }
+    }
+    std::sort(usages.begin(), usages.end(), [](const Usage &a, const Usage &b)
+              { return a.allocations * b.requests > b.allocations * a.requests; });
+    return usages;
+}
+
+/// @brief Forgets every command's totals.
+void TCP_AllocTracker::reset()
+{
+    std::lock_guard<TCP_Mutex> lock(totalsMutex());
+    totals().clear();
+}
+
+#ifdef TCP_SERVER_TRACK_ALLOCS
+
+/**
+ * @brief Charges one allocation to the calling thread's scope, if any.
+ */
+static inline void countAllocation(std::size_t size)
+{
+    AllocState &state = alloc_state;
+    if (state.counting)
+    {
+        ++state.allocations;
+        state.bytes += size;
+    }
+}
+
+/**
+ * @brief Allocates like the default operator new, including the new-handler.
+ * @return The memory, or nullptr if `nothrow` and none is available.
+ */
+static void *allocate(std::size_t size, std::size_t alignment, bool nothrow)
+{
+    countAllocation(size);
+    if (size == 0)
+    {
+        size = 1;
+    }
+    for (;;)
+    {
+        void *memory = nullptr;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            memory = std::malloc(size);
+        }
+        else if (posix_memalign(&memory, std::max(alignment, sizeof(void *)), size) != 0)
+        {
+            memory = nullptr;
+        }
+        if (memory != nullptr)
+        {
+            return memory;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+        {
+            if (nothrow)
+            {
+                return nullptr;
+            }
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+constexpr std::size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void *operator new(std::size_t size) { return allocate(size, DEFAULT_ALIGNMENT, false); }
+void *operator new[](std::size_t size) { return allocate(size, DEFAULT_ALIGNMENT, false); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, DEFAULT_ALIGNMENT, true); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, DEFAULT_ALIGNMENT, true); }
+void *operator new(std::size_t size, std::align_val_t align) { return allocate(size, static_cast<std::size_t>(align), false); }
+void *operator new[](std::size_t size, std::align_val_t align) { return allocate(size, static_cast<std::size_t>(align), false); }
+void *operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(align), true);
+}
+void *operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(align), true);
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
+
+#endif // TCP_SERVER_TRACK_ALLOCS
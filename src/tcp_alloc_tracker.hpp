@@ -0,0 +1,127 @@
+/**
+ * @file tcp_alloc_tracker.hpp
+ * @brief Heap allocations made while serving each command.
+ * @details This file defines TCP_AllocTracker. When the server is built with
+ *          `TCP_SERVER_TRACK_ALLOCS` defined (`make TRACK_ALLOCS=1`), the
+ *          global `operator new` and `operator delete` are replaced by
+ *          versions that count the allocations, and the bytes asked for,
+ *          of a thread inside a Scope. The server opens a Scope around each
+ *          command line it processes, from copying the line out of the
+ *          receive buffer to appending the response, and adds the counts to
+ *          the command's totals, which snapshot() reads.
+ *
+ *          In a normal build the operators are not replaced, Scope is empty
+ *          and name() does nothing, so the request path is unchanged.
+ *
+ *          The goal is a request path that does not allocate; the
+ *          allocation bench (`bench/alloc_bench.cpp`) fails when a command
+ *          allocates more than its recorded budget.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_ALLOC_TRACKER_HPP
+#define TCP_ALLOC_TRACKER_HPP
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class TCP_AllocTracker
+ * @brief Per-command heap allocation counts of the request path.
+ */
+class TCP_AllocTracker
+{
+public:
+#ifdef TCP_SERVER_TRACK_ALLOCS
+    /// @brief True when allocations are counted (`make TRACK_ALLOCS=1`).
+    static constexpr bool enabled = true;
+#else
+    /// @brief True when allocations are counted (`make TRACK_ALLOCS=1`).
+    static constexpr bool enabled = false;
+#endif
+
+    /// @brief Longest command name kept; longer ones are truncated.
+    static constexpr std::size_t NAME_SIZE = 31;
+
+    /**
+     * @struct Usage
+     * @brief Totals of one command.
+     */
+    struct Usage
+    {
+        std::string command;      ///< Command name.
+        uint64_t requests = 0;    ///< Requests counted.
+        uint64_t allocations = 0; ///< Calls to operator new.
+        uint64_t bytes = 0;       ///< Bytes asked for.
+    };
+
+    /**
+     * @class Scope
+     * @brief Counts the calling thread's allocations while it exists.
+     * @details On destruction the counts are added to the command last
+     *          given to name(); a scope that was never named (a blank
+     *          line) is not recorded. Scopes do not nest: an inner one
+     *          counts nothing.
+     */
+    class Scope
+    {
+    public:
+        Scope()
+        {
+            if constexpr (enabled)
+                active_ = start();
+        }
+
+        ~Scope()
+        {
+            if constexpr (enabled)
+                if (active_)
+                    stop();
+        }
+
+        // Disable copying.
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        bool active_ = false;
+    };
+
+    /**
+     * @brief Names the command the calling thread's scope is serving.
+     * @param command Command name; copied without allocating.
+     */
+    static void name(const std::string &command)
+    {
+        if constexpr (enabled)
+            setName(command.data(), command.size());
+    }
+
+    /**
+     * @brief Reads every command's totals.
+     * @return One entry per command, most allocations per request first.
+     */
+    static std::vector<Usage> snapshot();
+
+    /// @brief Forgets every command's totals.
+    static void reset();
+
+private:
+    /// @brief Starts counting; false if a scope is already open.
+    static bool start();
+
+    /// @brief Stops counting and records the counts.
+    static void stop();
+
+    /// @brief Sets the name the counts are recorded under.
+    static void setName(const char *command, std::size_t size);
+};
+
+#endif // TCP_ALLOC_TRACKER_HPP
@@ -0,0 +1,189 @@
+/**
+ * @file tcp_audit_log.cpp
+ * @brief Implementation of the memory-mapped audit log.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_audit_log.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <ctime>
+
+// System Includes
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @brief Identifies an audit file ("TCPAUDIT").
+constexpr const uint64_t AUDIT_MAGIC = 0x5449445541504354ULL;
+
+/// @brief Bumped whenever the file layout changes.
+constexpr const uint32_t AUDIT_LAYOUT = 1;
+
+/**
+ * @struct TCP_AuditLog::Header
+ * @brief First 64 bytes of the file; the records follow.
+ */
+struct alignas(64) TCP_AuditLog::Header
+{
+    uint64_t magic;             ///< AUDIT_MAGIC.
+    uint32_t layout;            ///< AUDIT_LAYOUT.
+    uint32_t record_size;       ///< sizeof(TCP_AuditRecord).
+    uint64_t capacity;          ///< Records in the ring.
+    std::atomic<uint64_t> next; ///< Records ever claimed.
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomic must be lock-free");
+
+/// @brief Returns the record array that follows a header.
+static TCP_AuditRecord *records(void *header)
+{
+    return reinterpret_cast<TCP_AuditRecord *>(static_cast<char *>(header) + 64);
+}
+
+/// @brief Copies `text` into a fixed field, NUL-padded.
+/// @return True if it had to be truncated.
+template <std::size_t N>
+static bool copyField(char (&field)[N], const std::string &text)
+{
+    std::size_t length = std::min(text.size(), N);
+    std::memcpy(field, text.data(), length);
+    return text.size() > N;
+}
+
+TCP_AuditLog::TCP_AuditLog()
+    : header_(nullptr),
+      size_(0)
+{
+}
+
+TCP_AuditLog::~TCP_AuditLog()
+{
+    close();
+}
+
+/**
+ * @brief Maps a ring file, creating or resizing it as needed.
+ * @param path File path.
+ * @param capacity Number of records in the ring.
+ * @return True if the file is mapped.
+ */
+bool TCP_AuditLog::open(const std::string &path, std::size_t capacity)
+{
+    static_assert(sizeof(Header) == 64, "records start at byte 64");
+    close();
+    if (capacity == 0)
+    {
+        return false;
+    }
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0640);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // One process at a time checks (and if needed resets) the header.
+    flock(fd, LOCK_EX);
+    const std::size_t size = sizeof(Header) + capacity * sizeof(TCP_AuditRecord);
+    struct stat st;
+    bool reset = fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != size;
+    if (reset && ftruncate(fd, 0) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    if (reset && ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    Header *header = static_cast<Header *>(mem);
+    if (reset || header->magic != AUDIT_MAGIC || header->layout != AUDIT_LAYOUT ||
+        header->record_size != sizeof(TCP_AuditRecord) || header->capacity != capacity)
+    {
+        std::memset(mem, 0, size);
+        header->layout = AUDIT_LAYOUT;
+        header->record_size = sizeof(TCP_AuditRecord);
+        header->capacity = capacity;
+        header->next.store(0, std::memory_order_relaxed);
+        header->magic = AUDIT_MAGIC;
+    }
+    flock(fd, LOCK_UN);
+    ::close(fd);
+
+    header_ = header;
+    size_ = size;
+    return true;
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+void TCP_AuditLog::close()
+{
+    if (header_ != nullptr)
+    {
+        munmap(header_, size_);
+        header_ = nullptr;
+    }
+}
+
+/**
+ * @brief Appends a record.
+ * @param session Session ID.
+ * @param peer Client "address:port".
+ * @param command Command name.
+ * @param arg Command argument.
+ * @param status Result of the command.
+ */
+void TCP_AuditLog::record(uint64_t session, const std::string &peer, const std::string &command,
+                          const std::string &arg, TCP_Status status)
+{
+    if (header_ == nullptr)
+    {
+        return;
+    }
+
+    // Build the record on the stack, then publish it with one copy.
+    TCP_AuditRecord record{};
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    record.time_ns = static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+    record.session = session;
+    record.status = static_cast<uint16_t>(status);
+    copyField(record.peer, peer);
+    copyField(record.command, command);
+    if (copyField(record.arg, arg))
+    {
+        record.flags |= TCP_AuditRecord::FLAG_TRUNCATED;
+    }
+
+    const uint64_t index = header_->next.fetch_add(1, std::memory_order_relaxed);
+    TCP_AuditRecord *slot = &records(header_)[index % header_->capacity];
+
+    // Readers treat sequence 0 as an incomplete slot: clear it first and
+    // set it last.
+    auto *sequence = reinterpret_cast<std::atomic<uint64_t> *>(&slot->sequence);
+    sequence->store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(reinterpret_cast<char *>(slot) + sizeof(uint64_t),
+                reinterpret_cast<const char *>(&record) + sizeof(uint64_t),
+                sizeof(TCP_AuditRecord) - sizeof(uint64_t));
+    sequence->store(index + 1, std::memory_order_release);
+}
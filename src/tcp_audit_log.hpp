@@ -0,0 +1,116 @@
+/**
+ * @file tcp_audit_log.hpp
+ * @brief Audit trail of state-changing commands in a memory-mapped ring file.
+ * @details This file defines TCP_AuditLog, which records who changed what:
+ *          every audited command becomes one fixed-size binary record
+ *          (time, session, peer, command, argument, status) in a file that
+ *          is mapped shared into the server. Writing a record is a slot
+ *          claim and one memcpy; nothing is formatted and no system call is
+ *          made. Because the mapping is shared, the records are in the page
+ *          cache as soon as they are written and survive a crash of the
+ *          server (though not of the machine, unless the kernel has flushed
+ *          them).
+ *
+ *          When the file is full the oldest records are overwritten.
+ *          Decode it with `scripts/audit_decode.py`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_AUDIT_LOG_HPP
+#define TCP_AUDIT_LOG_HPP
+
+// Project includes
+#include "tcp_reply.hpp"
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct TCP_AuditRecord
+ * @brief One audited command, exactly 128 bytes.
+ * @details Text fields are NUL-padded and truncated to fit; FLAG_TRUNCATED
+ *          marks a cut argument. `sequence` is written last and is 0 for a
+ *          slot that was never completed.
+ */
+struct TCP_AuditRecord
+{
+    static constexpr uint16_t FLAG_TRUNCATED = 1;
+
+    uint64_t sequence;  ///< 1-based write order.
+    int64_t time_ns;    ///< Wall-clock time, Unix nanoseconds.
+    uint64_t session;   ///< Session ID (0 outside a connection).
+    uint16_t status;    ///< TCP_Status of the command.
+    uint16_t flags;     ///< FLAG_* bits.
+    uint32_t reserved;  ///< Zero.
+    char peer[24];      ///< Client "address:port".
+    char command[16];   ///< Command name.
+    char arg[56];       ///< Command argument.
+};
+
+static_assert(sizeof(TCP_AuditRecord) == 128, "audit record layout changed");
+
+/**
+ * @class TCP_AuditLog
+ * @brief Appends TCP_AuditRecords to a shared ring file.
+ */
+class TCP_AuditLog
+{
+public:
+    TCP_AuditLog();
+    ~TCP_AuditLog();
+
+    // Disable copying.
+    TCP_AuditLog(const TCP_AuditLog &) = delete;
+    TCP_AuditLog &operator=(const TCP_AuditLog &) = delete;
+
+    /**
+     * @brief Maps a ring file, creating or resizing it as needed.
+     * @details An existing file with the same capacity is continued, so
+     *          records from earlier runs are kept; otherwise it is reset.
+     *          Several processes may map the same file.
+     *
+     * @param path File path.
+     * @param capacity Number of records in the ring.
+     * @return True if the file is mapped.
+     */
+    bool open(const std::string &path, std::size_t capacity);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether a file is mapped.
+     * @return True if open() succeeded.
+     */
+    bool isOpen() const { return header_ != nullptr; }
+
+    /**
+     * @brief Appends a record; does nothing if no file is mapped.
+     * @param session Session ID.
+     * @param peer Client "address:port".
+     * @param command Command name.
+     * @param arg Command argument.
+     * @param status Result of the command.
+     */
+    void record(uint64_t session, const std::string &peer, const std::string &command,
+                const std::string &arg, TCP_Status status);
+
+private:
+    struct Header;
+
+    /// @brief The mapped file: a Header followed by the records.
+    Header *header_;
+
+    /// @brief Bytes mapped.
+    std::size_t size_;
+};
+
+#endif // TCP_AUDIT_LOG_HPP
@@ -0,0 +1,515 @@
+/**
+ * @file tcp_client.cpp
+ * @brief Implementation of the pooled, pipelining client.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_client.hpp"
+
+// Standard Includes
+#include <cerrno>
+#include <cstring>
+
+// System Includes
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/// @brief Most asynchronous requests sent in one pipelined batch.
+constexpr std::size_t MAX_ASYNC_BATCH = 64;
+
+/**
+ * @brief Creates a client; no connection is opened until first use.
+ * @param host Server address.
+ * @param port Server port.
+ * @param pool_size Maximum number of open connections.
+ */
+TCP_Client::TCP_Client(const std::string &host, int port, std::size_t pool_size)
+    : host_(host),
+      port_(port),
+      pool_size_(pool_size ? pool_size : 1),
+      open_(0),
+      timeout_(std::chrono::seconds(5)),
+      attempts_(2),
+      backoff_(std::chrono::milliseconds(100)),
+      async_stopping_(false)
+{
+}
+
+/**
+ * @brief Closes all pooled connections.
+ * @details Asynchronous requests still queued complete with `ok == false`.
+ */
+TCP_Client::~TCP_Client()
+{
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        async_stopping_ = true;
+    }
+    async_cv_.notify_all();
+    if (async_thread_.joinable())
+    {
+        async_thread_.join();
+    }
+    for (auto &pending : async_queue_)
+    {
+        pending.promise.set_value(TCP_ClientResult());
+    }
+
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    for (int fd : idle_)
+    {
+        ::close(fd);
+    }
+    idle_.clear();
+}
+
+/**
+ * @brief Sets how failed requests are retried.
+ * @param attempts Total attempts per request (at least 1).
+ * @param backoff Delay before the third and later attempts.
+ */
+void TCP_Client::setRetry(int attempts, std::chrono::milliseconds backoff)
+{
+    attempts_ = attempts > 0 ? attempts : 1;
+    backoff_ = backoff;
+}
+
+/**
+ * @brief Sends one command and waits for its reply.
+ * @param command Command line without terminator.
+ * @param reply Receives the reply.
+ * @return False if the server could not be reached.
+ */
+bool TCP_Client::request(const std::string &command, std::string &reply)
+{
+    std::vector<std::string> replies;
+    if (!requestBatch({command}, replies))
+    {
+        return false;
+    }
+    reply = std::move(replies.front());
+    return true;
+}
+
+/**
+ * @brief Sends several commands in one write and reads all replies.
+ * @details The batch is sent again on a fresh connection (as configured
+ *          by setRetry()) only if none of it was written. After any byte
+ *          is written the commands may have run, so a timeout, a partial
+ *          reply or a close without a reply fails the request instead.
+ *
+ * @param commands Command lines without terminators.
+ * @param replies Receives one reply per command, in order.
+ * @return False if a command contains a line break, or the server could
+ *         not be reached or did not answer.
+ */
+bool TCP_Client::requestBatch(const std::vector<std::string> &commands, std::vector<std::string> &replies)
+{
+    if (!single_line(commands))
+    {
+        return false;
+    }
+    for (int attempt = 0; attempt < attempts_; ++attempt)
+    {
+        wait_before(attempt);
+        int fd = acquire(attempt > 0);
+        if (fd < 0)
+        {
+            continue;
+        }
+        bool unsent = false;
+        if (!write_commands(fd, commands, unsent))
+        {
+            release(fd, false);
+            if (unsent)
+            {
+                continue;
+            }
+            return false;
+        }
+        replies.clear();
+        bool ok = read_replies(fd, commands.size(), replies);
+        release(fd, ok);
+        return ok;
+    }
+    return false;
+}
+
+/**
+ * @brief Writes commands on a borrowed connection.
+ * @param commands Command lines without terminators.
+ * @return A connection handle, or -1 on failure.
+ */
+int TCP_Client::send(const std::vector<std::string> &commands)
+{
+    if (!single_line(commands))
+    {
+        return -1;
+    }
+    for (int attempt = 0; attempt < attempts_; ++attempt)
+    {
+        wait_before(attempt);
+        int fd = acquire(attempt > 0);
+        if (fd < 0)
+        {
+            continue;
+        }
+        bool unsent = false;
+        if (write_commands(fd, commands, unsent))
+        {
+            return fd;
+        }
+        release(fd, false);
+        if (!unsent)
+        {
+            break;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Reads the replies to a previous send() and releases the handle.
+ * @param handle The handle returned by send().
+ * @param count Number of replies to read.
+ * @param replies Receives the replies, in order.
+ * @param drop_on_error Close the connection if a reply is an error.
+ * @return False if the connection failed.
+ */
+bool TCP_Client::receive(int handle, std::size_t count, std::vector<std::string> &replies, bool drop_on_error)
+{
+    replies.clear();
+    bool ok = read_replies(handle, count, replies);
+    bool keep = ok;
+    for (std::size_t i = 0; keep && drop_on_error && i < replies.size(); ++i)
+    {
+        keep = replies[i].compare(0, 6, "ERROR:") != 0;
+    }
+    release(handle, keep);
+    return ok;
+}
+
+/**
+ * @brief Queues a command for the asynchronous sender.
+ * @param command Command line without terminator.
+ * @return A future for the result.
+ */
+std::future<TCP_ClientResult> TCP_Client::requestAsync(const std::string &command)
+{
+    AsyncRequest pending;
+    pending.command = command;
+    std::future<TCP_ClientResult> result = pending.promise.get_future();
+    if (command.find_first_of("\r\n") != std::string::npos)
+    {
+        // See single_line().
+        pending.promise.set_value(TCP_ClientResult());
+        return result;
+    }
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        if (async_stopping_)
+        {
+            pending.promise.set_value(TCP_ClientResult());
+            return result;
+        }
+        if (!async_thread_.joinable())
+        {
+            async_thread_ = std::thread(&TCP_Client::async_loop, this);
+        }
+        async_queue_.push_back(std::move(pending));
+    }
+    async_cv_.notify_one();
+    return result;
+}
+
+/**
+ * @brief Sends queued asynchronous requests in batches.
+ * @details Everything queued while the previous batch was in flight goes
+ *          out in the next write, so the batch size adapts to the load.
+ */
+void TCP_Client::async_loop()
+{
+    std::vector<AsyncRequest> batch;
+    std::vector<std::string> commands;
+    std::vector<std::string> replies;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(async_mutex_);
+            async_cv_.wait(lock, [this]
+                           { return async_stopping_ || !async_queue_.empty(); });
+            if (async_stopping_)
+            {
+                return;
+            }
+            while (!async_queue_.empty() && batch.size() < MAX_ASYNC_BATCH)
+            {
+                batch.push_back(std::move(async_queue_.front()));
+                async_queue_.pop_front();
+            }
+        }
+
+        commands.clear();
+        for (const auto &pending : batch)
+        {
+            commands.push_back(pending.command);
+        }
+        bool ok = requestBatch(commands, replies);
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            TCP_ClientResult result;
+            result.ok = ok;
+            if (ok)
+            {
+                result.reply = std::move(replies[i]);
+            }
+            batch[i].promise.set_value(std::move(result));
+        }
+        batch.clear();
+    }
+}
+
+/**
+ * @brief Sleeps before a retry if required.
+ * @param attempt The 0-based attempt about to start.
+ */
+void TCP_Client::wait_before(int attempt) const
+{
+    if (attempt > 1)
+    {
+        std::this_thread::sleep_for(backoff_);
+    }
+}
+
+/**
+ * @brief Checks, without blocking, that an idle connection is still usable.
+ * @details Nothing is sent on an idle connection, so readable data means
+ *          the server closed it (EOF) or broke protocol; either way it
+ *          must not be reused.
+ *
+ * @param fd An idle socket.
+ * @return True if no EOF, data, hangup or error is pending.
+ */
+bool TCP_Client::is_open(int fd)
+{
+    struct pollfd pfd = {fd, POLLIN | POLLRDHUP, 0};
+    int rc;
+    do
+    {
+        rc = ::poll(&pfd, 1, 0);
+    } while (rc < 0 && errno == EINTR);
+    return rc == 0;
+}
+
+/**
+ * @brief Checks that every command is a single line.
+ * @param commands Command lines without terminators.
+ * @return False if any command contains '\n' or '\r'.
+ */
+bool TCP_Client::single_line(const std::vector<std::string> &commands)
+{
+    for (const auto &command : commands)
+    {
+        if (command.find_first_of("\r\n") != std::string::npos)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Borrows an idle connection or opens a new one.
+ * @param fresh If true, never reuse an idle connection.
+ * @return A connected socket, or -1 on failure.
+ */
+int TCP_Client::acquire(bool fresh)
+{
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    pool_cv_.wait(lock, [this]
+                  { return !idle_.empty() || open_ < pool_size_; });
+    while (!idle_.empty() && !fresh)
+    {
+        int fd = idle_.back();
+        idle_.pop_back();
+        if (is_open(fd))
+        {
+            return fd;
+        }
+        // The server closed it while idle, e.g. on restart; replace it.
+        ::close(fd);
+        --open_;
+    }
+    if (open_ >= pool_size_)
+    {
+        // Make room for a fresh connection by dropping an idle one.
+        ::close(idle_.back());
+        idle_.pop_back();
+        --open_;
+    }
+    ++open_;
+    lock.unlock();
+
+    int fd = connect_socket();
+    if (fd < 0)
+    {
+        lock.lock();
+        --open_;
+        pool_cv_.notify_one();
+    }
+    return fd;
+}
+
+/**
+ * @brief Returns a connection to the pool, or closes it if unhealthy.
+ * @param fd The borrowed socket.
+ * @param healthy False if the connection must not be reused.
+ */
+void TCP_Client::release(int fd, bool healthy)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (healthy)
+        {
+            idle_.push_back(fd);
+        }
+        else
+        {
+            ::close(fd);
+            --open_;
+        }
+    }
+    pool_cv_.notify_one();
+}
+
+/**
+ * @brief Opens a new connection to the server.
+ * @return A connected socket, or -1 on failure.
+ */
+int TCP_Client::connect_socket() const
+{
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    if (inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) != 1)
+    {
+        return -1;
+    }
+
+    // Non-blocking so that connect, send and recv all honor the timeout.
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (errno != EINPROGRESS || !wait_ready(fd, POLLOUT) ||
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+    }
+    int opt = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    return fd;
+}
+
+/**
+ * @brief Waits until a socket is ready or the timeout expires.
+ * @param fd The socket.
+ * @param events POLLIN or POLLOUT.
+ * @return False on timeout or error.
+ */
+bool TCP_Client::wait_ready(int fd, short events) const
+{
+    struct pollfd pfd = {fd, events, 0};
+    int timeout = timeout_.count() > 0 ? static_cast<int>(timeout_.count()) : -1;
+    while (true)
+    {
+        int n = ::poll(&pfd, 1, timeout);
+        if (n < 0 && errno == EINTR)
+            continue;
+        return n > 0;
+    }
+}
+
+/**
+ * @brief Writes all commands, newline-terminated, in one buffer.
+ * @param unsent Set to true if the write failed before its first byte.
+ * @return True if every byte was sent.
+ */
+bool TCP_Client::write_commands(int fd, const std::vector<std::string> &commands, bool &unsent) const
+{
+    std::string buffer;
+    for (const auto &command : commands)
+    {
+        buffer += command;
+        buffer += '\n';
+    }
+    size_t sent = 0;
+    while (sent < buffer.size())
+    {
+        ssize_t n = ::send(fd, buffer.data() + sent, buffer.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && wait_ready(fd, POLLOUT))
+                continue;
+            unsent = sent == 0;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads exactly `count` newline-terminated replies.
+ * @details Replies arrive only in response to commands, so no bytes
+ *          beyond the last expected newline can be pending.
+ *
+ * @return False on timeout, disconnect, or a protocol error.
+ */
+bool TCP_Client::read_replies(int fd, std::size_t count, std::vector<std::string> &replies) const
+{
+    std::string pending;
+    char buffer[4096];
+    while (replies.size() < count)
+    {
+        if (!wait_ready(fd, POLLIN))
+        {
+            return false;
+        }
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+        {
+            if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+                continue;
+            return false;
+        }
+        pending.append(buffer, static_cast<size_t>(n));
+        size_t start = 0;
+        size_t end;
+        while ((end = pending.find('\n', start)) != std::string::npos)
+        {
+            replies.emplace_back(pending, start, end - start);
+            start = end + 1;
+        }
+        pending.erase(0, start);
+    }
+    return replies.size() == count && pending.empty();
+}
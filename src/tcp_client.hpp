@@ -0,0 +1,257 @@
+/**
+ * @file tcp_client.hpp
+ * @brief Pooled, pipelining client for TCP-Server instances.
+ * @details This file defines TCP_Client, which keeps a small pool of
+ *          persistent connections to one server and sends
+ *          newline-terminated commands over them. A batch of commands is
+ *          written in a single send and the replies are read back in order,
+ *          so N commands cost one round trip instead of N connections.
+ *
+ *          Asynchronous requests return a future; requests queued while
+ *          the previous batch is in flight are pipelined together. Every
+ *          socket operation is bounded by a timeout. A request is retried
+ *          on a fresh connection only if none of it was written (the
+ *          connect failed, or the send failed before its first byte), so
+ *          no command is ever sent twice. Idle connections the server
+ *          closed, e.g. on restart, are noticed before reuse.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_CLIENT_HPP
+#define TCP_CLIENT_HPP
+
+// Standard includes
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct TCP_ClientResult
+ * @brief Outcome of an asynchronous request.
+ */
+struct TCP_ClientResult
+{
+    bool ok = false;   ///< False if the command was rejected or the server could not be reached in time.
+    std::string reply; ///< The reply without its terminator, if `ok`.
+};
+
+/**
+ * @class TCP_Client
+ * @brief Connection pool and request pipeline for one server endpoint.
+ * @details Request methods are thread-safe. Each request borrows a pooled
+ *          connection for its duration; up to `pool_size` requests run
+ *          concurrently and further callers wait for a free connection.
+ */
+class TCP_Client
+{
+public:
+    /**
+     * @brief Creates a client; no connection is opened until first use.
+     *
+     * @param host Server address (dotted IPv4).
+     * @param port Server port.
+     * @param pool_size Maximum number of open connections.
+     */
+    TCP_Client(const std::string &host, int port, std::size_t pool_size = 4);
+
+    /**
+     * @brief Closes all pooled connections.
+     */
+    ~TCP_Client();
+
+    // Disable copying.
+    TCP_Client(const TCP_Client &) = delete;
+    TCP_Client &operator=(const TCP_Client &) = delete;
+
+    /**
+     * @brief Sets the limit for connecting and for each send or receive.
+     * @details A connection that times out is closed, since its reply
+     *          stream can no longer be trusted. Configure before first use.
+     *
+     * @param timeout The limit; zero disables it. Default 5 seconds.
+     */
+    void setTimeout(std::chrono::milliseconds timeout) { timeout_ = timeout; }
+
+    /**
+     * @brief Sets how requests that did not reach the server are retried.
+     * @details Only a failed connect, or a send that failed before writing
+     *          anything, is retried. Once any byte is written the server
+     *          may run the commands, even if the connection then closes
+     *          without a reply (the server may be stopping), so such a
+     *          request fails rather than risk running `incr` or `set`
+     *          twice. The first retry happens at once on a fresh
+     *          connection; later retries wait `backoff` first. Configure
+     *          before first use.
+     *
+     * @param attempts Total attempts per request (at least 1). Default 2.
+     * @param backoff Delay before the third and later attempts.
+     */
+    void setRetry(int attempts, std::chrono::milliseconds backoff);
+
+    /**
+     * @brief Sends one command and waits for its reply.
+     *
+     * @param command Command line without terminator, e.g. "freq 7040100".
+     * @param reply Receives the reply without its terminator.
+     * @return False if the command contains a line break, or the server
+     *         could not be reached.
+     */
+    bool request(const std::string &command, std::string &reply);
+
+    /**
+     * @brief Sends several commands in one write and reads all replies.
+     *
+     * @param commands Command lines without terminators.
+     * @param replies Receives one reply per command, in order.
+     * @return False if a command contains a line break, or the server
+     *         could not be reached.
+     */
+    bool requestBatch(const std::vector<std::string> &commands, std::vector<std::string> &replies);
+
+    /**
+     * @brief Queues a command and returns its eventual reply.
+     * @details A background thread sends everything queued so far as one
+     *          pipelined batch, so many concurrent callers share round trips.
+     *
+     * @param command Command line without terminator.
+     * @return A future for the result.
+     */
+    std::future<TCP_ClientResult> requestAsync(const std::string &command);
+
+    /**
+     * @name Split Requests
+     * @brief Send now, read later, to overlap requests to several servers.
+     * @details `send()` borrows a connection and writes the commands;
+     *          `receive()` reads their replies and returns the connection
+     *          to the pool. Every successful `send()` must be followed by
+     *          exactly one `receive()` with the returned handle.
+     */
+    ///@{
+
+    /**
+     * @brief Writes commands on a borrowed connection.
+     * @param commands Command lines without terminators.
+     * @return A connection handle, or -1 if a command contains a line
+     *         break or the write failed.
+     */
+    int send(const std::vector<std::string> &commands);
+
+    /**
+     * @brief Reads the replies to a previous send() and releases the handle.
+     * @param handle The handle returned by send().
+     * @param count Number of replies to read.
+     * @param replies Receives the replies, in order.
+     * @param drop_on_error Close the connection instead of pooling it if a
+     *                      reply is an error, so the server's error budget
+     *                      for it starts over on the next connection.
+     * @return False if the connection failed.
+     */
+    bool receive(int handle, std::size_t count, std::vector<std::string> &replies, bool drop_on_error = false);
+    ///@}
+
+    /// @brief Returns "host:port" for messages.
+    std::string endpoint() const { return host_ + ":" + std::to_string(port_); }
+
+    /// @brief Returns the server address.
+    const std::string &host() const { return host_; }
+
+    /// @brief Returns the server port.
+    int port() const { return port_; }
+
+private:
+    std::string host_;
+    int port_;
+    std::size_t pool_size_;
+
+    /// @brief Idle connected sockets.
+    std::vector<int> idle_;
+
+    /// @brief Number of sockets currently open (idle or borrowed).
+    std::size_t open_;
+
+    std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+
+    /// @brief Socket operation limit; zero for none.
+    std::chrono::milliseconds timeout_;
+
+    /// @brief Total attempts per request.
+    int attempts_;
+
+    /// @brief Delay before the third and later attempts.
+    std::chrono::milliseconds backoff_;
+
+    /// @brief A queued asynchronous request.
+    struct AsyncRequest
+    {
+        std::string command;
+        std::promise<TCP_ClientResult> promise;
+    };
+
+    /// @brief Asynchronous requests waiting to be sent.
+    std::deque<AsyncRequest> async_queue_;
+    std::mutex async_mutex_;
+    std::condition_variable async_cv_;
+    std::thread async_thread_;
+    bool async_stopping_;
+
+    /// @brief Sends queued asynchronous requests in batches.
+    void async_loop();
+
+    /// @brief Sleeps before retry `attempt` (0-based) if required.
+    void wait_before(int attempt) const;
+
+    /// @brief Checks, without blocking, that an idle connection is usable.
+    static bool is_open(int fd);
+
+    /**
+     * @brief Checks that every command is a single line.
+     * @details A command with an embedded '\n' or '\r' would be answered
+     *          with more than one reply, and every later request on the
+     *          connection would read the wrong one.
+     */
+    static bool single_line(const std::vector<std::string> &commands);
+
+    /**
+     * @brief Borrows an idle connection or opens a new one.
+     * @param fresh If true, never reuse an idle connection.
+     * @return A connected socket, or -1 on failure.
+     */
+    int acquire(bool fresh);
+
+    /**
+     * @brief Returns a connection to the pool, or closes it if unhealthy.
+     */
+    void release(int fd, bool healthy);
+
+    /**
+     * @brief Opens a new connection to the server.
+     * @return A connected socket, or -1 on failure.
+     */
+    int connect_socket() const;
+
+    /// @brief Waits until `fd` is ready for `events` or the timeout expires.
+    bool wait_ready(int fd, short events) const;
+
+    /**
+     * @brief Writes all commands, newline-terminated, in one buffer.
+     * @param unsent Set to true if the write failed before its first byte.
+     * @return True if every byte was sent.
+     */
+    bool write_commands(int fd, const std::vector<std::string> &commands, bool &unsent) const;
+
+    /// @brief Reads exactly `count` newline-terminated replies.
+    bool read_replies(int fd, std::size_t count, std::vector<std::string> &replies) const;
+};
+
+#endif // TCP_CLIENT_HPP
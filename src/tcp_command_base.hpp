@@ -0,0 +1,71 @@
+/**
+ * @file tcp_command_base.hpp
+ * @brief CRTP base class for statically bound TCP command handlers.
+ * @details This file defines TCP_StaticCommandHandler, which implements the
+ *          TCP_CommandHandler interface by forwarding to the derived class
+ *          without any virtual call. A server instantiated with the derived
+ *          type (see BasicTCPServer) resolves the entire dispatch chain at
+ *          compile time, while a `TCP_CommandHandler *` to the same object
+ *          still works for dynamically selected handlers.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_COMMAND_BASE_H
+#define TCP_COMMAND_BASE_H
+
+// Project includes
+#include "tcp_command_interface.hpp"
+
+// Standard includes
+#include <string>
+
+/**
+ * @class TCP_StaticCommandHandler
+ * @brief CRTP adapter from TCP_CommandHandler to a concrete handler.
+ * @details `Derived` must implement `processCommand()` with and without
+ *          a session. Because both `handleCommand()` overloads are `final`
+ *          and call `Derived::processCommand()` with a qualified name, calls
+ *          made through a `Derived *` are neither virtual nor opaque to the
+ *          optimizer.
+ *
+ * @tparam Derived The concrete handler class.
+ */
+template <typename Derived>
+class TCP_StaticCommandHandler : public TCP_CommandHandler
+{
+public:
+    /**
+     * @brief Handles an incoming command by forwarding to the derived class.
+     *
+     * @param command The command name.
+     * @param arg The argument passed with the command, if any.
+     * @return Response string generated by the handler.
+     */
+    std::string handleCommand(const std::string &command, const std::string &arg) final
+    {
+        return derived().Derived::processCommand(command, arg);
+    }
+
+    /**
+     * @brief Handles a command from a client connection.
+     *
+     * @param session State of the client connection.
+     * @param command The command name.
+     * @param arg The argument passed with the command, if any.
+     * @return Response string generated by the handler.
+     */
+    std::string handleCommand(TCP_Session &session, const std::string &command, const std::string &arg) final
+    {
+        return derived().Derived::processCommand(session, command, arg);
+    }
+
+protected:
+    /// @brief Returns this object as the derived handler type.
+    Derived &derived() { return static_cast<Derived &>(*this); }
+};
+
+#endif // TCP_COMMAND_BASE_H
@@ -0,0 +1,77 @@
+/**
+ * @file tcp_command_costs.cpp
+ * @brief Implementation of the per-command cost accounting.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_command_costs.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <ctime>
+
+TCP_CommandCosts::TCP_CommandCosts()
+    : commands_("costs")
+{
+    other_.name = OTHER;
+}
+
+/**
+ * @brief Adds one request to a command's totals.
+ * @param command Command name.
+ * @param cpu_ns Thread CPU time the handler used.
+ * @param wall_ns Wall time the handler took.
+ */
+void TCP_CommandCosts::record(const std::string &command, uint64_t cpu_ns, uint64_t wall_ns)
+{
+    Table::Entry *entry = commands_.findOrCreate(command);
+    Shard &shard = (entry != nullptr ? entry : &other_)->local();
+    shard.requests.fetch_add(1, std::memory_order_relaxed);
+    shard.cpu_ns.fetch_add(cpu_ns, std::memory_order_relaxed);
+    shard.wall_ns.fetch_add(wall_ns, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reads every command's totals.
+ * @return One entry per command, most CPU time first.
+ */
+std::vector<TCP_CommandCosts::Cost> TCP_CommandCosts::snapshot() const
+{
+    std::vector<Cost> costs;
+    const std::size_t count = commands_.size();
+    costs.reserve(count + 1);
+    for (std::size_t i = 0; i <= count; ++i)
+    {
+        const Table::Entry &command = i < count ? commands_.at(i) : other_;
+        Cost cost;
+        cost.command = command.name;
+        for (const auto &shard : command.shards)
+        {
+            cost.requests += shard.requests.load(std::memory_order_relaxed);
+            cost.cpu_ns += shard.cpu_ns.load(std::memory_order_relaxed);
+            cost.wall_ns += shard.wall_ns.load(std::memory_order_relaxed);
+        }
+        if (cost.requests != 0)
+        {
+            costs.push_back(std::move(cost));
+        }
+    }
+    std::sort(costs.begin(), costs.end(), [](const Cost &a, const Cost &b)
+              { return a.cpu_ns > b.cpu_ns; });
+    return costs;
+}
+
+/**
+ * @brief Returns the CPU time the calling thread has used.
+ * @return Nanoseconds of `CLOCK_THREAD_CPUTIME_ID`.
+ */
+uint64_t TCP_CommandCosts::threadCpuNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
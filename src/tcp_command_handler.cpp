@@ -18,6 +18,40 @@
  */
 
 #include "tcp_command_handler.hpp"
+#include "tcp_profiler.hpp"
+
+// Standard includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <limits>
+#include <sstream>
+
+// System includes
+#include <unistd.h>
+
+/**
+ * @brief Parses a signed decimal integer that fills the whole string.
+ * @return False if `text` is not an integer or is out of range.
+ */
+static bool parseInteger(const char *text, int64_t &value)
+{
+    char *end;
+    errno = 0;
+    long long parsed = std::strtoll(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0')
+    {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+/// @brief Parameters that can be subscribed to.
+static const std::unordered_set<std::string> PARAMETERS = {
+    "transmit", "call", "grid", "power", "freq", "ppm", "selfcal", "offset", "led"};
 
 /**
  * @brief Constructs the TCP_Commands.
@@ -27,10 +61,47 @@ TCP_Commands::TCP_Commands()
 {
     valid_commands = {
         "transmit", "call", "grid", "power", "freq", "ppm", "selfcal",
-        "offset", "led", "port", "xmit", "version", "help"};
+        "offset", "led", "port", "xmit", "version", "help", "session",
+        "subscribe", "unsubscribe", "changes", "get", "set", "del", "incr",
+        "decr", "add", "counter", "history", "macro", "run",
+        "stats", "profile", "auth"};
 
     // Initialize command handlers
     initializeHandlers();
+
+    // Keep parameter values in a private store until a shared one is attached.
+    params.open("");
+}
+
+/**
+ * @brief Moves parameter values into a shared-memory store.
+ * @param name POSIX shared-memory object name.
+ * @return True if the store was attached.
+ */
+bool TCP_Commands::attachStore(const std::string &name)
+{
+    if (params.open(name))
+    {
+        return true;
+    }
+    params.open("");
+    return false;
+}
+
+/**
+ * @brief Keeps the last `capacity` numeric values written to a parameter.
+ * @param key Parameter name.
+ * @param capacity Number of samples to keep.
+ * @return False if `key` is not a parameter command.
+ */
+bool TCP_Commands::enableHistory(const std::string &key, std::size_t capacity)
+{
+    if (PARAMETERS.count(key) == 0)
+    {
+        return false;
+    }
+    histories[key] = std::make_unique<TCP_History>(capacity);
+    return true;
 }
 
 /**
@@ -39,62 +110,85 @@ TCP_Commands::TCP_Commands()
 void TCP_Commands::initializeHandlers()
 {
     // Handlers requiring an argument:
-    command_handlers["transmit"] = [this](const std::string &arg)
-    { return handleTransmit(arg); };
-    command_handlers["call"] = [this](const std::string &arg)
-    { return handleCall(arg); };
-    command_handlers["grid"] = [this](const std::string &arg)
-    { return handleGrid(arg); };
-    command_handlers["power"] = [this](const std::string &arg)
-    { return handlePower(arg); };
-    command_handlers["freq"] = [this](const std::string &arg)
-    { return handleFreq(arg); };
-    command_handlers["ppm"] = [this](const std::string &arg)
-    { return handlePPM(arg); };
-    command_handlers["selfcal"] = [this](const std::string &arg)
-    { return handleSelfCal(arg); };
-    command_handlers["offset"] = [this](const std::string &arg)
-    { return handleOffset(arg); };
-    command_handlers["led"] = [this](const std::string &arg)
-    { return handleLED(arg); };
-
-    // Handlers that do not require an argument:
-    command_handlers["port"] = [this](const std::string &)
-    { return handlePort(); };
-    command_handlers["xmit"] = [this](const std::string &)
-    { return handleXmit(); };
-    command_handlers["version"] = [this](const std::string &)
-    { return handleVersion(); };
-    command_handlers["help"] = [this](const std::string &)
-    { return handleHelp(); };
+    command_handlers["transmit"] = &TCP_Commands::handleTransmit;
+    command_handlers["call"] = &TCP_Commands::handleCall;
+    command_handlers["grid"] = &TCP_Commands::handleGrid;
+    command_handlers["power"] = &TCP_Commands::handlePower;
+    command_handlers["freq"] = &TCP_Commands::handleFreq;
+    command_handlers["ppm"] = &TCP_Commands::handlePPM;
+    command_handlers["selfcal"] = &TCP_Commands::handleSelfCal;
+    command_handlers["offset"] = &TCP_Commands::handleOffset;
+    command_handlers["led"] = &TCP_Commands::handleLED;
+
+    // Handlers that ignore their argument:
+    command_handlers["port"] = &TCP_Commands::handlePort;
+    command_handlers["xmit"] = &TCP_Commands::handleXmit;
+    command_handlers["version"] = &TCP_Commands::handleVersion;
+    command_handlers["help"] = &TCP_Commands::handleHelp;
+
+    // Handlers working on the client's session:
+    command_handlers["session"] = &TCP_Commands::handleSession;
+    command_handlers["auth"] = &TCP_Commands::handleAuth;
+    command_handlers["subscribe"] = &TCP_Commands::handleSubscribe;
+    command_handlers["unsubscribe"] = &TCP_Commands::handleUnsubscribe;
+    command_handlers["changes"] = &TCP_Commands::handleChanges;
+
+    // Generic key-value handlers:
+    command_handlers["get"] = &TCP_Commands::handleGet;
+    command_handlers["set"] = &TCP_Commands::handleSet;
+    command_handlers["del"] = &TCP_Commands::handleDel;
+
+    // Counter handlers:
+    command_handlers["incr"] = &TCP_Commands::handleIncr;
+    command_handlers["decr"] = &TCP_Commands::handleDecr;
+    command_handlers["add"] = &TCP_Commands::handleAdd;
+    command_handlers["counter"] = &TCP_Commands::handleCounter;
+
+    // History handlers:
+    command_handlers["history"] = &TCP_Commands::handleHistory;
+
+    // Macro handlers:
+    command_handlers["macro"] = &TCP_Commands::handleMacro;
+    command_handlers["run"] = &TCP_Commands::handleRun;
+
+    // Diagnostic handlers:
+    command_handlers["stats"] = &TCP_Commands::handleStats;
+    command_handlers["profile"] = &TCP_Commands::handleProfile;
 }
 
 /**
- * @brief Processes a command by calling the appropriate handler function.
+ * @brief Processes a command outside of any connection.
  * @param command The command name.
  * @param arg The argument passed with the command.
  * @return A response string based on the command.
  */
 std::string TCP_Commands::processCommand(const std::string &command, const std::string &arg)
 {
-    auto it = command_handlers.find(command);
-    if (it != command_handlers.end())
+    TCP_Session session;
+    std::string reply = processCommand(session, command, arg);
+    if (session.failed())
     {
-        return it->second(arg);
+        session.renderError(reply);
     }
-    return "ERROR: Unknown command '" + command + "'. Type 'help' for a list of commands.";
+    return reply;
 }
 
 /**
- * @brief Handles an incoming command.
- * @details Determines if the command is valid and routes it to the appropriate handler.
+ * @brief Processes a command by calling the appropriate handler function.
+ * @param session State of the client connection.
  * @param command The command name.
- * @param arg The argument (if any).
- * @return Response string generated by the handler.
+ * @param arg The argument passed with the command.
+ * @return A response string based on the command.
  */
-std::string TCP_Commands::handleCommand(const std::string &command, const std::string &arg)
+std::string TCP_Commands::processCommand(TCP_Session &session, const std::string &command, const std::string &arg)
 {
-    return processCommand(command, arg);
+    auto it = command_handlers.find(command);
+    if (it != command_handlers.end())
+    {
+        return (this->*(it->second))(session, arg);
+    }
+    session.fail(TCP_Status::UNKNOWN_COMMAND, command);
+    return std::string();
 }
 
 /**
@@ -106,88 +200,680 @@ const std::unordered_set<std::string> &TCP_Commands::getValidCommands() const
     return valid_commands;
 }
 
+/**
+ * @brief Tells whether a command always completes without blocking.
+ * @param command The command name.
+ * @return True for every known command except `profile`, `macro` and `run`.
+ */
+bool TCP_Commands::isQuick(const std::string &command) const
+{
+    return command != "profile" && command != "macro" && command != "run" && valid_commands.count(command) != 0;
+}
+
+/**
+ * @brief Gets or sets a stored parameter.
+ * @param session Selects the reply format.
+ * @param label Name used in text replies.
+ * @param key Parameter name in the store.
+ * @param arg New value, or empty to read the current one.
+ * @return Response string.
+ */
+std::string TCP_Commands::parameter(TCP_Session &session, const char *label, const char *key, const std::string &arg)
+{
+    if (arg.empty())
+    {
+        std::string value;
+        bool found = params.get(key, value);
+        if (session.terse())
+        {
+            return found ? TCP_Reply::value(value) : TCP_Reply::status(TCP_Status::NO_VALUE);
+        }
+        return found ? std::string(label) + " " + value
+                     : std::string(label) + " <example response>";
+    }
+
+    bool stored;
+    if (parameters_read_only)
+    {
+        // A replica's parameters follow the primary.
+        stored = false;
+    }
+    else if (change_listener)
+    {
+        std::lock_guard<TCP_Mutex> lock(change_mutex);
+        stored = params.set(key, arg);
+        if (stored)
+        {
+            change_listener(key, arg);
+        }
+    }
+    else
+    {
+        stored = params.set(key, arg);
+    }
+
+    audit.record(session.id, session.peer, key, arg, stored ? TCP_Status::OK : TCP_Status::STORE_FAILED);
+    if (!stored)
+    {
+        session.fail(TCP_Status::STORE_FAILED, key);
+        return std::string();
+    }
+
+    // Only numeric values are recorded; they are what dashboards plot.
+    auto history = histories.find(key);
+    if (history != histories.end())
+    {
+        char *end;
+        double value = std::strtod(arg.c_str(), &end);
+        if (end != arg.c_str() && *end == '\0')
+        {
+            history->second->record(value);
+        }
+    }
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : std::string(label) + " set to " + arg;
+}
+
+/**
+ * @brief Adds to a named counter.
+ * @param session Selects the reply format.
+ * @param arg "<name> [amount]".
+ * @param sign 1 to add the amount, -1 to subtract it.
+ * @param required True if the amount must be given.
+ * @return Response string.
+ */
+std::string TCP_Commands::adjustCounter(TCP_Session &session, const std::string &arg, int64_t sign, bool required)
+{
+    auto pos = arg.find(' ');
+    int64_t delta = 1;
+    if ((pos == std::string::npos && required) ||
+        (pos != std::string::npos && !parseInteger(arg.c_str() + pos + 1, delta)) ||
+        (sign < 0 && delta == std::numeric_limits<int64_t>::min()))
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+
+    // The reply does not carry the total: reading it would sum every shard.
+    std::string name = arg.substr(0, pos);
+    if (!counts.add(name, sign * delta))
+    {
+        session.fail(TCP_Status::STORE_FAILED, name);
+        return std::string();
+    }
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : name + " changed by " + std::to_string(sign * delta);
+}
+
+/**
+ * @brief Parses a macro definition into resolved steps.
+ * @param source "<command>; <command>; ...".
+ * @param macro Receives the steps.
+ * @return False if a command is unknown or not allowed in a macro.
+ */
+bool TCP_Commands::compileMacro(const std::string &source, Macro &macro) const
+{
+    std::stringstream commands(source);
+    std::string line;
+    while (std::getline(commands, line, ';'))
+    {
+        // Trim, then split into command and argument as the server does.
+        auto first = line.find_first_not_of(' ');
+        if (first == std::string::npos)
+        {
+            continue;
+        }
+        line = line.substr(first, line.find_last_not_of(' ') - first + 1);
+        auto pos = line.find(' ');
+        std::string command = line.substr(0, pos);
+        std::string arg = pos == std::string::npos ? "" : line.substr(pos + 1);
+
+        // Macros may not run or edit macros, so a run always terminates.
+        auto it = command_handlers.find(command);
+        if (it == command_handlers.end() || command == "macro" || command == "run" ||
+            macro.steps.size() == MAX_MACRO_STEPS)
+        {
+            return false;
+        }
+
+        MacroStep step{it->second, {}};
+        std::string literal;
+        for (std::size_t i = 0; i < arg.size(); ++i)
+        {
+            if (arg[i] == '$' && i + 1 < arg.size() && arg[i + 1] >= '1' && arg[i + 1] <= '9')
+            {
+                if (!literal.empty())
+                {
+                    step.pieces.emplace_back(0, std::move(literal));
+                    literal.clear();
+                }
+                int parameter = arg[++i] - '0';
+                step.pieces.emplace_back(parameter, std::string());
+                macro.arity = std::max(macro.arity, parameter);
+            }
+            else
+            {
+                literal += arg[i];
+            }
+        }
+        if (!literal.empty())
+        {
+            step.pieces.emplace_back(0, std::move(literal));
+        }
+        macro.steps.push_back(std::move(step));
+    }
+    return !macro.steps.empty();
+}
+
 /**
  * @name Command Handlers
  * @brief Functions responsible for handling each command.
- * @details If an argument is provided, it parrots it back. Otherwise, it returns a default response.
+ * @details If an argument is provided, it is stored and echoed back.
+ *          Otherwise, the stored value (or a default response) is returned.
  */
 ///@{
 
 /// @brief Handles the "transmit" command.
-std::string TCP_Commands::handleTransmit(const std::string &arg)
+std::string TCP_Commands::handleTransmit(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "Transmit <example response>" : "Transmit set to " + arg;
+    return parameter(session, "Transmit", "transmit", arg);
 }
 
 /// @brief Handles the "call" command.
-std::string TCP_Commands::handleCall(const std::string &arg)
+std::string TCP_Commands::handleCall(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "Call <example response>" : "Call set to " + arg;
+    return parameter(session, "Call", "call", arg);
 }
 
 /// @brief Handles the "grid" command.
-std::string TCP_Commands::handleGrid(const std::string &arg)
+std::string TCP_Commands::handleGrid(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "Grid <example response>" : "Grid set to " + arg;
+    return parameter(session, "Grid", "grid", arg);
 }
 
 /// @brief Handles the "power" command.
-std::string TCP_Commands::handlePower(const std::string &arg)
+std::string TCP_Commands::handlePower(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "Power <example response>" : "Power set to " + arg;
+    return parameter(session, "Power", "power", arg);
 }
 
 /// @brief Handles the "freq" command.
-std::string TCP_Commands::handleFreq(const std::string &arg)
+std::string TCP_Commands::handleFreq(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "Freq <example response>" : "Freq set to " + arg;
+    return parameter(session, "Freq", "freq", arg);
 }
 
 /// @brief Handles the "ppm" command.
-std::string TCP_Commands::handlePPM(const std::string &arg)
+std::string TCP_Commands::handlePPM(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "PPM <example response>" : "PPM set to " + arg;
+    return parameter(session, "PPM", "ppm", arg);
 }
 
 /// @brief Handles the "selfcal" command.
-std::string TCP_Commands::handleSelfCal(const std::string &arg)
+std::string TCP_Commands::handleSelfCal(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "SelfCal <example response>" : "SelfCal set to " + arg;
+    return parameter(session, "SelfCal", "selfcal", arg);
 }
 
 /// @brief Handles the "offset" command.
-std::string TCP_Commands::handleOffset(const std::string &arg)
+std::string TCP_Commands::handleOffset(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "Offset <example response>" : "Offset set to " + arg;
+    return parameter(session, "Offset", "offset", arg);
 }
 
 /// @brief Handles the "led" command.
-std::string TCP_Commands::handleLED(const std::string &arg)
+std::string TCP_Commands::handleLED(TCP_Session &session, const std::string &arg)
+{
+    return parameter(session, "LED", "led", arg);
+}
+
+/// @brief Handles the "port" command (argument ignored).
+std::string TCP_Commands::handlePort(TCP_Session &session, const std::string &)
+{
+    return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : "Port <example response>";
+}
+
+/// @brief Handles the "xmit" command (argument ignored).
+std::string TCP_Commands::handleXmit(TCP_Session &session, const std::string &)
+{
+    return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : "Xmit <example response>";
+}
+
+/// @brief Handles the "version" command (argument ignored).
+std::string TCP_Commands::handleVersion(TCP_Session &session, const std::string &)
+{
+    static const std::string terse = TCP_Reply::value("1.0.0");
+    return session.terse() ? terse : "Version 1.0.0";
+}
+
+/// @brief Handles the "help" command (argument ignored).
+std::string TCP_Commands::handleHelp(TCP_Session &session, const std::string &)
+{
+    static const std::string commands =
+        "transmit, call, grid, power, freq, ppm, selfcal, offset, led, port, xmit, version, help, "
+        "session, auth, subscribe, unsubscribe, changes, get, set, del, incr, decr, add, counter, history, macro, run, stats, profile";
+    static const std::string terse = TCP_Reply::value(commands);
+    if (session.terse())
+    {
+        return terse;
+    }
+    return session.verbosity > 0 ? "Available commands: " + commands : commands;
+}
+
+/// @brief Handles the "auth" command.
+std::string TCP_Commands::handleAuth(TCP_Session &session, const std::string &arg)
+{
+    if (!session.authenticate(admin_token, arg))
+    {
+        // Never echo the attempted token.
+        session.fail(TCP_Status::NOT_PERMITTED, "auth");
+        return std::string();
+    }
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : "Authenticated";
+}
+
+/// @brief Handles the "session" command.
+std::string TCP_Commands::handleSession(TCP_Session &session, const std::string &arg)
+{
+    if (arg.empty())
+    {
+        const std::string summary =
+            std::to_string(session.id) + (session.peer.empty() ? "" : " " + session.peer) +
+            " protocol " + (session.terse() ? "terse" : "text") +
+            " verbosity " + std::to_string(session.verbosity) +
+            " auth " + std::to_string(session.auth_level) +
+            " subscriptions " + std::to_string(session.subscriptions.size());
+        return session.terse() ? TCP_Reply::value(summary) : "Session " + summary;
+    }
+
+    auto pos = arg.find(' ');
+    std::string setting = arg.substr(0, pos);
+    std::string value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+    if (setting == "verbosity" && (value == "0" || value == "1"))
+    {
+        session.verbosity = value[0] - '0';
+    }
+    else if (setting == "protocol" && value == "text")
+    {
+        session.protocol = TCP_Protocol::TEXT;
+    }
+    else if (setting == "protocol" && value == "terse")
+    {
+        session.protocol = TCP_Protocol::TERSE;
+    }
+    else
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : "Session " + setting + " set to " + value;
+}
+
+/// @brief Handles the "subscribe" command.
+std::string TCP_Commands::handleSubscribe(TCP_Session &session, const std::string &arg)
+{
+    if (arg.empty())
+    {
+        std::string reply = session.terse() ? "0" : "Subscriptions";
+        for (const auto &subscription : session.subscriptions)
+        {
+            reply += ' ';
+            reply += subscription.first;
+        }
+        return reply;
+    }
+    if (PARAMETERS.count(arg) == 0)
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+
+    // Only changes made after subscribing are reported.
+    std::string value;
+    uint64_t version = 0;
+    params.get(arg, value, &version);
+    session.subscriptions[arg] = version;
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : "Subscribed to " + arg;
+}
+
+/// @brief Handles the "unsubscribe" command.
+std::string TCP_Commands::handleUnsubscribe(TCP_Session &session, const std::string &arg)
+{
+    if (session.subscriptions.erase(arg) == 0)
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : "Unsubscribed from " + arg;
+}
+
+/// @brief Handles the "changes" command (argument ignored).
+std::string TCP_Commands::handleChanges(TCP_Session &session, const std::string &)
+{
+    std::string reply = session.terse() ? "0" : "Changes";
+    bool changed = false;
+    std::string value;
+    for (auto &subscription : session.subscriptions)
+    {
+        uint64_t version = 0;
+        if (params.get(subscription.first, value, &version) && version != subscription.second)
+        {
+            subscription.second = version;
+            reply += ' ' + subscription.first + '=' + value;
+            changed = true;
+        }
+    }
+    if (!changed)
+    {
+        return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : "Changes none";
+    }
+    return reply;
+}
+
+/// @brief Handles the "get" command.
+std::string TCP_Commands::handleGet(TCP_Session &session, const std::string &arg)
+{
+    std::string value;
+    if (!kv.get(arg, value))
+    {
+        return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : arg + " not set";
+    }
+    return session.terse() ? TCP_Reply::value(value) : arg + " " + value;
+}
+
+/// @brief Handles the "set" command.
+std::string TCP_Commands::handleSet(TCP_Session &session, const std::string &arg)
+{
+    auto pos = arg.find(' ');
+    if (pos == std::string::npos || pos == 0)
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+    std::string key = arg.substr(0, pos);
+    std::string value = arg.substr(pos + 1);
+    bool stored = kv.set(key, value);
+    audit.record(session.id, session.peer, "set", arg, stored ? TCP_Status::OK : TCP_Status::STORE_FAILED);
+    if (!stored)
+    {
+        session.fail(TCP_Status::STORE_FAILED, key);
+        return std::string();
+    }
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : key + " set to " + value;
+}
+
+/// @brief Handles the "del" command.
+std::string TCP_Commands::handleDel(TCP_Session &session, const std::string &arg)
+{
+    bool erased = kv.erase(arg);
+    audit.record(session.id, session.peer, "del", arg, erased ? TCP_Status::OK : TCP_Status::NO_VALUE);
+    if (!erased)
+    {
+        return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : arg + " not set";
+    }
+    return session.terse() ? TCP_Reply::status(TCP_Status::OK) : arg + " deleted";
+}
+
+/// @brief Handles the "incr" command.
+std::string TCP_Commands::handleIncr(TCP_Session &session, const std::string &arg)
+{
+    return adjustCounter(session, arg, 1, false);
+}
+
+/// @brief Handles the "decr" command.
+std::string TCP_Commands::handleDecr(TCP_Session &session, const std::string &arg)
+{
+    return adjustCounter(session, arg, -1, false);
+}
+
+/// @brief Handles the "add" command.
+std::string TCP_Commands::handleAdd(TCP_Session &session, const std::string &arg)
 {
-    return arg.empty() ? "LED <example response>" : "LED set to " + arg;
+    return adjustCounter(session, arg, 1, true);
 }
 
-/// @brief Handles the "port" command (no argument required).
-std::string TCP_Commands::handlePort()
+/// @brief Handles the "counter" command.
+std::string TCP_Commands::handleCounter(TCP_Session &session, const std::string &arg)
 {
-    return "Port <example response>";
+    if (arg.empty())
+    {
+        std::string reply = session.terse() ? "0" : "Counters";
+        for (const auto &counter : counts.snapshot())
+        {
+            reply += ' ' + counter.first + '=' + std::to_string(counter.second);
+        }
+        return reply;
+    }
+
+    int64_t value;
+    if (!counts.read(arg, value))
+    {
+        return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : arg + " not set";
+    }
+    return session.terse() ? TCP_Reply::value(std::to_string(value)) : arg + " " + std::to_string(value);
 }
 
-/// @brief Handles the "xmit" command (no argument required).
-std::string TCP_Commands::handleXmit()
+/// @brief Handles the "stats" command.
+std::string TCP_Commands::handleStats(TCP_Session &session, const std::string &arg)
 {
-    return "Xmit <example response>";
+    if (!stats_reporter)
+    {
+        return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : "Stats not available";
+    }
+    std::string figures = stats_reporter(arg);
+    if (figures.empty())
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+    return (session.terse() ? "0 " : "Stats ") + figures;
 }
 
-/// @brief Handles the "version" command (no argument required).
-std::string TCP_Commands::handleVersion()
+/// @brief Handles the "profile" command.
+std::string TCP_Commands::handleProfile(TCP_Session &session, const std::string &arg)
 {
-    return "Version 1.0.0";
+    if (!session.admin())
+    {
+        session.fail(TCP_Status::NOT_PERMITTED, "profile");
+        return std::string();
+    }
+    std::istringstream tokens(arg);
+    std::string seconds, extra;
+    tokens >> seconds >> extra;
+    int64_t duration = 0;
+    if (!parseInteger(seconds.c_str(), duration) || duration <= 0 ||
+        duration > static_cast<int64_t>(TCP_Profiler::MAX_SECONDS) || !extra.empty())
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+
+    // Clients never choose the file: a new one is created in the
+    // configured directory.
+    const std::string path = profile_directory + "/tcp-server-" + std::to_string(getpid()) + "-" +
+                             std::to_string(std::time(nullptr)) + ".folded";
+
+    // Blocks this connection for the duration; other clients are sampled.
+    TCP_Profiler::Result result;
+    std::string error;
+    if (!TCP_Profiler::profile(static_cast<unsigned>(duration), path, result, error))
+    {
+        return session.terse() ? TCP_Reply::status(TCP_Status::NO_VALUE) : "Profile failed: " + error;
+    }
+    const std::string summary = std::to_string(result.samples) + " " + std::to_string(result.stacks) + " " + path;
+    if (session.terse())
+    {
+        return TCP_Reply::value(summary);
+    }
+    return "Profile " + std::to_string(result.samples) + " samples (" + std::to_string(result.dropped) +
+           " dropped) in " + std::to_string(result.stacks) + " stacks written to " + path;
 }
 
-/// @brief Handles the "help" command (no argument required).
-std::string TCP_Commands::handleHelp()
+/// @brief Handles the "history" command.
+std::string TCP_Commands::handleHistory(TCP_Session &session, const std::string &arg)
 {
-    return "Available commands: transmit, call, grid, power, freq, ppm, selfcal, offset, led, port, xmit, version, help";
+    std::istringstream tokens(arg);
+    std::string key;
+    tokens >> key;
+    auto history = histories.find(key);
+    if (history == histories.end())
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+
+    int64_t count = 0;
+    int64_t since = 0;
+    int64_t every = 0;
+    std::string token;
+    while (tokens >> token)
+    {
+        std::string value;
+        bool ok;
+        if (token == "since" || token == "every")
+        {
+            ok = static_cast<bool>(tokens >> value) &&
+                 parseInteger(value.c_str(), token == "since" ? since : every);
+        }
+        else
+        {
+            ok = parseInteger(token.c_str(), count) && count > 0;
+        }
+        if (!ok)
+        {
+            session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+            return std::string();
+        }
+    }
+
+    auto samples = history->second->query(static_cast<std::size_t>(count), since, every);
+    std::string reply = session.terse() ? "0 " : "History " + key + " ";
+    reply += std::to_string(samples.size());
+    char sample[64];
+    for (const auto &s : samples)
+    {
+        std::snprintf(sample, sizeof(sample), " %lld:%.15g", static_cast<long long>(s.time_ms), s.value);
+        reply += sample;
+    }
+    return reply;
+}
+
+/// @brief Handles the "macro" command.
+std::string TCP_Commands::handleMacro(TCP_Session &session, const std::string &arg)
+{
+    std::istringstream tokens(arg);
+    std::string action;
+    std::string name;
+    tokens >> action >> name;
+
+    if (action == "list" && name.empty())
+    {
+        std::string reply = session.terse() ? "0" : "Macros";
+        std::lock_guard<TCP_Mutex> lock(macro_mutex);
+        for (const auto &macro : macros)
+        {
+            reply += ' ';
+            reply += macro.first;
+        }
+        return reply;
+    }
+    if ((action == "define" || action == "delete") && !session.admin())
+    {
+        session.fail(TCP_Status::NOT_PERMITTED, "macro " + action);
+        return std::string();
+    }
+    if (action == "define" && !name.empty())
+    {
+        std::string source;
+        std::getline(tokens >> std::ws, source);
+        auto macro = std::make_shared<Macro>();
+        macro->source = source;
+        if (!compileMacro(source, *macro))
+        {
+            session.fail(TCP_Status::INVALID_ARGUMENT, source);
+            return std::string();
+        }
+        std::lock_guard<TCP_Mutex> lock(macro_mutex);
+        if (macros.count(name) == 0 && macros.size() == MAX_MACROS)
+        {
+            session.fail(TCP_Status::STORE_FAILED, name);
+            return std::string();
+        }
+        std::size_t steps = macro->steps.size();
+        macros[name] = std::move(macro);
+        return session.terse() ? TCP_Reply::status(TCP_Status::OK)
+                               : "Macro " + name + " defined with " + std::to_string(steps) + " commands";
+    }
+    if (action == "show" && !name.empty())
+    {
+        std::lock_guard<TCP_Mutex> lock(macro_mutex);
+        auto it = macros.find(name);
+        if (it != macros.end())
+        {
+            return session.terse() ? TCP_Reply::value(it->second->source)
+                                   : "Macro " + name + ": " + it->second->source;
+        }
+    }
+    else if (action == "delete" && !name.empty())
+    {
+        std::lock_guard<TCP_Mutex> lock(macro_mutex);
+        if (macros.erase(name) > 0)
+        {
+            return session.terse() ? TCP_Reply::status(TCP_Status::OK) : "Macro " + name + " deleted";
+        }
+    }
+    session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+    return std::string();
+}
+
+/// @brief Handles the "run" command.
+std::string TCP_Commands::handleRun(TCP_Session &session, const std::string &arg)
+{
+    std::istringstream tokens(arg);
+    std::string name;
+    tokens >> name;
+    std::vector<std::string> arguments;
+    std::string token;
+    while (tokens >> token)
+    {
+        arguments.push_back(token);
+    }
+
+    std::shared_ptr<const Macro> macro;
+    {
+        std::lock_guard<TCP_Mutex> lock(macro_mutex);
+        auto it = macros.find(name);
+        if (it != macros.end())
+        {
+            macro = it->second;
+        }
+    }
+    if (!macro || static_cast<int>(arguments.size()) < macro->arity)
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+
+    // Steps are already resolved: only substitution and the calls remain.
+    std::string reply;
+    std::string step_arg;
+    for (const auto &step : macro->steps)
+    {
+        step_arg.clear();
+        for (const auto &piece : step.pieces)
+        {
+            step_arg += piece.first == 0 ? piece.second : arguments[piece.first - 1];
+        }
+        std::string step_reply = (this->*(step.method))(session, step_arg);
+        if (session.failed())
+        {
+            // The failing command's error is the reply; earlier steps stand.
+            return std::string();
+        }
+        if (!reply.empty())
+        {
+            reply += "; ";
+        }
+        reply += step_reply;
+    }
+    return reply;
 }
 ///@}
@@ -21,21 +21,35 @@
 #define TCP_COMMAND_HANDLER_H
 
 // Project includes
-#include "tcp_command_interface.hpp"
+#include "tcp_audit_log.hpp"
+#include "tcp_command_base.hpp"
+#include "tcp_counters.hpp"
+#include "tcp_history.hpp"
+#include "tcp_kv_store.hpp"
+#include "tcp_param_store.hpp"
+#include "tcp_reply.hpp"
 
 // Standard includes
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 /**
  * @class TCP_Commands
  * @brief Implements command handling with dedicated methods per command.
  * @details This class dynamically maps valid commands to handler functions
- *          and provides a structured approach to command execution.
+ *          and provides a structured approach to command execution. It
+ *          derives from TCP_StaticCommandHandler, so a server instantiated
+ *          with `TCP_Commands` dispatches without virtual calls.
  */
-class TCP_Commands : public TCP_CommandHandler
+class TCP_Commands final : public TCP_StaticCommandHandler<TCP_Commands>
 {
+    friend class TCP_StaticCommandHandler<TCP_Commands>;
+
 public:
     /**
      * @brief Constructs the TCP_Commands handler.
@@ -44,23 +58,157 @@ public:
     TCP_Commands();
 
     /**
-     * @brief Handles an incoming command.
-     * @details Determines if the command is valid and routes it to the
-     *          appropriate handler.
+     * @brief Retrieves the list of valid commands.
+     * @return A set containing valid command strings.
+     */
+    const std::unordered_set<std::string> &getValidCommands() const override;
+
+    /**
+     * @brief Tells whether a command always completes without blocking.
+     * @details Every command is quick except `profile`, which sleeps, and
+     *          `macro` and `run`, which run other commands.
      *
      * @param command The command name.
-     * @param arg The argument passed with the command, if any.
-     * @return Response string generated by the handler.
+     * @return True if the command may run on the accept thread.
      */
-    std::string handleCommand(const std::string &command, const std::string &arg) override;
+    bool isQuick(const std::string &command) const override;
 
     /**
-     * @brief Retrieves the list of valid commands.
-     * @return A set containing valid command strings.
+     * @brief Moves parameter values into a shared-memory store.
+     * @details By default values live in a store private to this process.
+     *          Attaching a named store lets other server processes and
+     *          out-of-process readers see the same values.
+     *
+     * @param name POSIX shared-memory object name, e.g. `/tcp-server.31415.params`.
+     * @return True if the store was attached; otherwise the private store is kept.
      */
-    const std::unordered_set<std::string> &getValidCommands() const override;
+    bool attachStore(const std::string &name);
+
+    /**
+     * @brief Provides direct access to the parameter store.
+     * @return The store backing the parameter commands.
+     */
+    TCP_ParamStore &parameters() { return params; }
+
+    /**
+     * @brief Provides direct access to the key-value store.
+     * @return The store backing the get, set and del commands.
+     */
+    TCP_KVStore &values() { return kv; }
+
+    /**
+     * @brief Provides direct access to the counters.
+     * @return The counters backing the incr, decr, add and counter commands.
+     */
+    TCP_Counters &counters() { return counts; }
+
+    /**
+     * @brief Records every parameter, set and del change in an audit file.
+     * @details See TCP_AuditLog. Must be called before the server starts.
+     *
+     * @param path Audit file path.
+     * @param capacity Records kept before the oldest are overwritten.
+     * @return True if the file was opened.
+     */
+    bool attachAuditLog(const std::string &path, std::size_t capacity) { return audit.open(path, capacity); }
+
+    /**
+     * @brief Keeps the last `capacity` numeric values written to a parameter.
+     * @details Enables the `history` command for that parameter. Must be
+     *          called before the server starts.
+     *
+     * @param key Parameter name, e.g. `freq`.
+     * @param capacity Number of samples to keep.
+     * @return False if `key` is not a parameter command.
+     */
+    bool enableHistory(const std::string &key, std::size_t capacity);
+
+    /// @brief Called with the name and value of every successful parameter set.
+    using ChangeListener = std::function<void(const std::string &, const std::string &)>;
+
+    /**
+     * @brief Registers a listener for parameter changes (e.g. replication).
+     * @details The store update and the listener call happen under one lock,
+     *          so listeners observe changes in the order they were applied.
+     *          Must be called before the server starts.
+     *
+     * @param listener The listener, or nullptr to remove it.
+     */
+    void setChangeListener(ChangeListener listener) { change_listener = std::move(listener); }
+
+    /// @brief Returns a section of server statistics as space-separated
+    ///        `name=value` pairs, or an empty string for an unknown section.
+    using StatsReporter = std::function<std::string(const std::string &section)>;
+
+    /**
+     * @brief Registers the source of the `stats` command's reply.
+     * @details The handler does not know the server it runs in, so the
+     *          application supplies the figures. Must be called before the
+     *          server starts.
+     *
+     * @param reporter The reporter, or nullptr to disable `stats`.
+     */
+    void setStatsReporter(StatsReporter reporter) { stats_reporter = std::move(reporter); }
+
+    /**
+     * @brief Sets the directory `profile` writes its folded stacks to.
+     * @details Each profile creates a new file named after the process and
+     *          the time; existing files are never replaced.
+     *
+     * @param directory The directory (default `/tmp`).
+     */
+    void setProfileDirectory(const std::string &directory) { profile_directory = directory; }
+
+    /**
+     * @brief Makes the parameter commands read-only.
+     * @details Used on a replica that follows a primary: its parameters
+     *          change only through replication, and a local set fails with
+     *          STORE_FAILED. Must be called before the server starts.
+     *
+     * @param read_only True to reject parameter sets.
+     */
+    void setParametersReadOnly(bool read_only) { parameters_read_only = read_only; }
+
+    /**
+     * @brief Sets the token `auth` checks before allowing admin commands.
+     * @details `profile`, `macro define` and `macro delete` need a session
+     *          authenticated with `auth <token>`. With no token (the
+     *          default) they are disabled. Must be called before the
+     *          server starts.
+     *
+     * @param token The token, or empty to disable admin commands.
+     */
+    void setAdminToken(const std::string &token) { admin_token = token; }
 
 private:
+    /// @brief Pointer to a command handler member function.
+    using CommandMethod = std::string (TCP_Commands::*)(TCP_Session &session, const std::string &);
+
+    /// @brief Maximum number of stored macros.
+    static constexpr std::size_t MAX_MACROS = 64;
+
+    /// @brief Maximum number of commands in one macro.
+    static constexpr std::size_t MAX_MACRO_STEPS = 16;
+
+    /**
+     * @brief One command of a macro, resolved when the macro is defined.
+     * @details The argument is a list of pieces: literal text, or a
+     *          parameter number (`$1` to `$9`) substituted at run time.
+     */
+    struct MacroStep
+    {
+        CommandMethod method;                            ///< Resolved handler.
+        std::vector<std::pair<int, std::string>> pieces; ///< (0, text) or (N, "") for $N.
+    };
+
+    /// @brief A stored macro.
+    struct Macro
+    {
+        std::string source;            ///< Definition as given, for `macro show`.
+        std::vector<MacroStep> steps;  ///< Precompiled commands.
+        int arity = 0;                 ///< Highest $N used.
+    };
+
     /**
      * @brief Stores valid command names.
      * @details This set ensures that only predefined commands are processed.
@@ -69,9 +217,79 @@ private:
 
     /**
      * @brief Maps commands to their respective handler functions.
-     * @details Uses function pointers to dynamically execute commands.
+     * @details Uses member function pointers rather than `std::function`
+     *          so a lookup is followed by a single direct call.
+     */
+    std::unordered_map<std::string, CommandMethod> command_handlers;
+
+    /**
+     * @brief Holds the values of the parameter commands.
+     */
+    TCP_ParamStore params;
+
+    /**
+     * @brief Holds the values of the generic key-value commands.
+     */
+    TCP_KVStore kv;
+
+    /**
+     * @brief Holds the named counters.
+     */
+    TCP_Counters counts;
+
+    /**
+     * @brief Value history of the parameters enabled with enableHistory().
+     * @details Filled before the server starts and read-only afterwards,
+     *          so lookups need no lock; each history locks itself.
+     */
+    std::unordered_map<std::string, std::unique_ptr<TCP_History>> histories;
+
+    /**
+     * @brief Audit trail of state changes, if attached.
+     */
+    TCP_AuditLog audit;
+
+    /**
+     * @brief Stored macros by name.
+     * @details Entries are immutable; running a macro copies its pointer, so
+     *          redefining it does not disturb runs in progress.
+     */
+    std::unordered_map<std::string, std::shared_ptr<const Macro>> macros;
+
+    /**
+     * @brief Guards `macros`.
+     */
+    TCP_Mutex macro_mutex{"macros"};
+
+    /**
+     * @brief Optional observer of parameter changes.
+     */
+    ChangeListener change_listener;
+
+    /**
+     * @brief Optional source of server statistics.
+     */
+    StatsReporter stats_reporter;
+
+    /**
+     * @brief Directory that receives profiles.
+     */
+    std::string profile_directory = "/tmp";
+
+    /**
+     * @brief True if parameter commands may only read.
      */
-    std::unordered_map<std::string, std::function<std::string(const std::string &)>> command_handlers;
+    bool parameters_read_only = false;
+
+    /**
+     * @brief Token that authenticates clients for admin commands.
+     */
+    std::string admin_token;
+
+    /**
+     * @brief Orders store updates with listener notifications.
+     */
+    TCP_Mutex change_mutex{"changes"};
 
     /**
      * @brief Initializes command handlers.
@@ -80,13 +298,50 @@ private:
     void initializeHandlers();
 
     /**
-     * @brief Processes a command by calling its associated handler.
+     * @brief Processes a command outside of any connection.
      * @param command The command name.
      * @param arg The argument provided, if any.
      * @return The response from the executed command.
      */
     std::string processCommand(const std::string &command, const std::string &arg) override;
 
+    /**
+     * @brief Processes a command by calling its associated handler.
+     * @param session State of the client connection.
+     * @param command The command name.
+     * @param arg The argument provided, if any.
+     * @return The response from the executed command.
+     */
+    std::string processCommand(TCP_Session &session, const std::string &command, const std::string &arg);
+
+    /**
+     * @brief Gets or sets a stored parameter.
+     * @param session Selects the reply format.
+     * @param label Name used in text replies, e.g. "Power".
+     * @param key Parameter name in the store, e.g. "power".
+     * @param arg New value, or empty to read the current one.
+     * @return Response string.
+     */
+    std::string parameter(TCP_Session &session, const char *label, const char *key, const std::string &arg);
+
+    /**
+     * @brief Adds to a named counter.
+     * @param session Selects the reply format.
+     * @param arg "<name> [amount]".
+     * @param sign 1 to add the amount, -1 to subtract it.
+     * @param required True if the amount must be given; otherwise it defaults to 1.
+     * @return Response string.
+     */
+    std::string adjustCounter(TCP_Session &session, const std::string &arg, int64_t sign, bool required);
+
+    /**
+     * @brief Parses a macro definition into resolved steps.
+     * @param source "<command>; <command>; ...".
+     * @param macro Receives the steps.
+     * @return False if a command is unknown or not allowed in a macro.
+     */
+    bool compileMacro(const std::string &source, Macro &macro) const;
+
     /**
      * @name Command Handlers
      * @brief Functions responsible for handling each command.
@@ -98,63 +353,150 @@ private:
     /// @brief Handles the "transmit" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handleTransmit(const std::string &arg);
+    std::string handleTransmit(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "call" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handleCall(const std::string &arg);
+    std::string handleCall(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "grid" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handleGrid(const std::string &arg);
+    std::string handleGrid(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "power" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handlePower(const std::string &arg);
+    std::string handlePower(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "freq" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handleFreq(const std::string &arg);
+    std::string handleFreq(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "ppm" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handlePPM(const std::string &arg);
+    std::string handlePPM(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "selfcal" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handleSelfCal(const std::string &arg);
+    std::string handleSelfCal(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "offset" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handleOffset(const std::string &arg);
+    std::string handleOffset(TCP_Session &session, const std::string &arg);
 
     /// @brief Handles the "led" command.
     /// @param arg The argument to set or retrieve.
     /// @return Response string.
-    std::string handleLED(const std::string &arg);
+    std::string handleLED(TCP_Session &session, const std::string &arg);
 
-    /// @brief Handles the "port" command (no argument required).
+    /// @brief Handles the "port" command (argument ignored).
     /// @return Response string.
-    std::string handlePort();
+    std::string handlePort(TCP_Session &session, const std::string &);
 
-    /// @brief Handles the "xmit" command (no argument required).
+    /// @brief Handles the "xmit" command (argument ignored).
     /// @return Response string.
-    std::string handleXmit();
+    std::string handleXmit(TCP_Session &session, const std::string &);
 
-    /// @brief Handles the "version" command (no argument required).
+    /// @brief Handles the "version" command (argument ignored).
     /// @return Response string.
-    std::string handleVersion();
+    std::string handleVersion(TCP_Session &session, const std::string &);
 
-    /// @brief Handles the "help" command (no argument required).
+    /// @brief Handles the "help" command (argument ignored).
     /// @return Response string listing available commands.
-    std::string handleHelp();
+    std::string handleHelp(TCP_Session &session, const std::string &);
+
+    /// @brief Handles the "session" command: shows or changes session settings.
+    /// @param arg Empty, "verbosity <0|1>" or "protocol <text|terse>".
+    /// @return Response string.
+    std::string handleSession(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "auth" command: authenticates the session.
+    /// @param arg The admin token.
+    /// @return Response string.
+    std::string handleAuth(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "subscribe" command: watches a parameter.
+    /// @param arg The parameter, or empty to list subscriptions.
+    /// @return Response string.
+    std::string handleSubscribe(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "unsubscribe" command.
+    /// @param arg The parameter to stop watching.
+    /// @return Response string.
+    std::string handleUnsubscribe(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "changes" command (argument ignored).
+    /// @return Subscribed parameters changed since they were last reported.
+    std::string handleChanges(TCP_Session &session, const std::string &);
+
+    /// @brief Handles the "get" command: reads a key.
+    /// @param arg The key.
+    /// @return Response string.
+    std::string handleGet(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "set" command: stores a key.
+    /// @param arg "<key> <value>".
+    /// @return Response string.
+    std::string handleSet(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "del" command: removes a key.
+    /// @param arg The key.
+    /// @return Response string.
+    std::string handleDel(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "incr" command: increments a counter.
+    /// @param arg "<name> [amount]"; the amount defaults to 1.
+    /// @return Response string.
+    std::string handleIncr(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "decr" command: decrements a counter.
+    /// @param arg "<name> [amount]"; the amount defaults to 1.
+    /// @return Response string.
+    std::string handleDecr(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "add" command: adds a signed amount to a counter.
+    /// @param arg "<name> <amount>".
+    /// @return Response string.
+    std::string handleAdd(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "counter" command: reads counters.
+    /// @param arg The counter, or empty to list all of them.
+    /// @return Response string.
+    std::string handleCounter(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "macro" command: defines, lists, shows or deletes macros.
+    /// @param arg "define <name> <command>; <command>; ...", "list",
+    ///            "show <name>" or "delete <name>"; define and delete
+    ///            need an authenticated session.
+    /// @return Response string.
+    std::string handleMacro(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "run" command: runs a macro.
+    /// @param arg "<name> [arguments...]".
+    /// @return The replies of the macro's commands, separated by "; ".
+    std::string handleRun(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "history" command: returns recent parameter values.
+    /// @param arg "<param> [count] [since <unix_ms>] [every <ms>]".
+    /// @return Response string with the samples, oldest first.
+    std::string handleHistory(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "stats" command: returns server statistics.
+    /// @param arg Section, e.g. "locks", or empty for the server figures.
+    /// @return Response string of `name=value` pairs.
+    std::string handleStats(TCP_Session &session, const std::string &arg);
+
+    /// @brief Handles the "profile" command: samples the process's CPU use.
+    /// @param arg "<seconds>"; the folded stacks go to a new file in the
+    ///            profile directory. Needs an authenticated session.
+    /// @return Response string with the sample count and the file.
+    std::string handleProfile(TCP_Session &session, const std::string &arg);
     ///@}
 };
 
@@ -17,6 +17,9 @@
 #ifndef TCP_COMMAND_INTERFACE_H
 #define TCP_COMMAND_INTERFACE_H
 
+// Project includes
+#include "tcp_session.hpp"
+
 // Standard includes
 #include <string>
 #include <unordered_set>
@@ -43,6 +46,24 @@ public:
      */
     virtual std::string handleCommand(const std::string &command, const std::string &arg) = 0;
 
+    /**
+     * @brief Handles a command received on a client connection.
+     * @details The server calls this overload with the connection's
+     *          session. The default ignores the session and calls the
+     *          two-argument overload, so stateless handlers need not
+     *          implement it.
+     *
+     * @param session State of the client connection.
+     * @param command The command string received from the client.
+     * @param arg The argument associated with the command, if any.
+     * @return A response string to be sent back to the client.
+     */
+    virtual std::string handleCommand(TCP_Session &session, const std::string &command, const std::string &arg)
+    {
+        (void)session;
+        return handleCommand(command, arg);
+    }
+
     /**
      * @brief Processes a command before handling.
      * @details Allows for command preprocessing, validation, or logging
@@ -63,6 +84,34 @@ public:
      */
     virtual const std::unordered_set<std::string> &getValidCommands() const = 0;
 
+    /**
+     * @brief Tells whether a command always completes without blocking.
+     * @details The server may run such commands on its accept thread (see
+     *          the one-shot fast path); anything that waits on a timer, the
+     *          network or another client must return false. The default
+     *          declares no command quick.
+     *
+     * @param command The command name.
+     * @return True if the command never blocks.
+     */
+    virtual bool isQuick(const std::string &command) const
+    {
+        (void)command;
+        return false;
+    }
+
+    /**
+     * @brief Called once when a client connection closes.
+     * @details Lets handlers release state they keep per session. The
+     *          default does nothing.
+     *
+     * @param session State of the connection that closed.
+     */
+    virtual void sessionClosed(TCP_Session &session)
+    {
+        (void)session;
+    }
+
     /**
      * @brief Virtual destructor for safe polymorphic deletion.
      * @details Defined inline to eliminate the need for a separate .cpp file.
@@ -0,0 +1,61 @@
+/**
+ * @file tcp_counters.cpp
+ * @brief Implementation of the per-CPU sharded counters.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_counters.hpp"
+
+TCP_Counters::TCP_Counters()
+    : counters_("counters")
+{
+}
+
+bool TCP_Counters::add(const std::string &name, int64_t delta)
+{
+    Table::Entry *counter = counters_.findOrCreate(name);
+    if (counter == nullptr)
+    {
+        return false;
+    }
+    counter->local().value.fetch_add(delta, std::memory_order_relaxed);
+    return true;
+}
+
+int64_t TCP_Counters::sum(const Table::Entry &counter)
+{
+    int64_t value = 0;
+    for (const auto &shard : counter.shards)
+    {
+        value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+bool TCP_Counters::read(const std::string &name, int64_t &value) const
+{
+    const Table::Entry *counter = counters_.find(name);
+    if (counter == nullptr)
+    {
+        return false;
+    }
+    value = sum(*counter);
+    return true;
+}
+
+std::vector<std::pair<std::string, int64_t>> TCP_Counters::snapshot() const
+{
+    std::vector<std::pair<std::string, int64_t>> counters;
+    const std::size_t count = counters_.size();
+    counters.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Table::Entry &counter = counters_.at(i);
+        counters.emplace_back(counter.name, sum(counter));
+    }
+    return counters;
+}
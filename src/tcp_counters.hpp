@@ -0,0 +1,95 @@
+/**
+ * @file tcp_counters.hpp
+ * @brief Named counters sharded per CPU for contention-free increments.
+ * @details This file defines TCP_Counters, which backs the incr, decr and
+ *          add commands. Each counter is an array of SHARDS atomics, one per
+ *          cache line; an update adds to the shard of the CPU it runs on, so
+ *          clients incrementing the same counter from different cores do not
+ *          bounce one cache line between them. Reads sum the shards.
+ *
+ *          Counters are created on first use and never removed. Looking a
+ *          counter up takes no lock; only creating one does (see
+ *          TCP_NamedTable).
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_COUNTERS_HPP
+#define TCP_COUNTERS_HPP
+
+// Project includes
+#include "tcp_named_table.hpp"
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class TCP_Counters
+ * @brief A fixed-capacity table of per-CPU sharded counters.
+ */
+class TCP_Counters
+{
+public:
+    /// @brief Shards per counter; CPUs beyond this share shards.
+    static constexpr std::size_t SHARDS = TCP_NamedTableBase::SHARDS;
+
+    /// @brief Maximum number of counters.
+    static constexpr std::size_t MAX_COUNTERS = 256;
+
+    /// @brief Maximum counter name length.
+    static constexpr std::size_t NAME_SIZE = TCP_NamedTableBase::NAME_SIZE;
+
+    TCP_Counters();
+
+    // Disable copying.
+    TCP_Counters(const TCP_Counters &) = delete;
+    TCP_Counters &operator=(const TCP_Counters &) = delete;
+
+    /**
+     * @brief Adds `delta` to a counter, creating it at 0 on first use.
+     * @param name Counter name, 1 to NAME_SIZE characters.
+     * @param delta Amount to add; may be negative.
+     * @return False if the name is invalid or MAX_COUNTERS already exist.
+     */
+    bool add(const std::string &name, int64_t delta);
+
+    /**
+     * @brief Reads a counter by summing its shards.
+     * @details Concurrent updates may or may not be included.
+     *
+     * @param name Counter name.
+     * @param value Receives the total.
+     * @return False if the counter does not exist.
+     */
+    bool read(const std::string &name, int64_t &value) const;
+
+    /**
+     * @brief Reads every counter.
+     * @return Name/total pairs in creation order.
+     */
+    std::vector<std::pair<std::string, int64_t>> snapshot() const;
+
+private:
+    /// @brief One shard of a counter, alone on its cache line.
+    struct alignas(64) Shard
+    {
+        std::atomic<int64_t> value{0};
+    };
+
+    using Table = TCP_NamedTable<Shard, MAX_COUNTERS>;
+
+    Table counters_;
+
+    /// @brief Sums a counter's shards.
+    static int64_t sum(const Table::Entry &counter);
+};
+
+#endif // TCP_COUNTERS_HPP
@@ -0,0 +1,340 @@
+/**
+ * @file tcp_flight_recorder.cpp
+ * @brief Implementation of the per-thread request flight recorder.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_flight_recorder.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+// System Includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/// @brief Identifies a flight recorder mapping ("TCPFLIGH").
+constexpr const uint64_t FLIGHT_MAGIC = 0x4847494C46504354ULL;
+
+/// @brief Bumped whenever the layout changes.
+constexpr const uint32_t FLIGHT_LAYOUT = 1;
+
+static_assert(sizeof(TCP_FlightRecorder::Entry) == 128, "flight entry layout changed");
+
+/**
+ * @struct TCP_FlightRecorder::Header
+ * @brief First 64 bytes of the mapping.
+ */
+struct alignas(64) TCP_FlightRecorder::Header
+{
+    uint64_t magic;        ///< FLIGHT_MAGIC.
+    uint32_t layout;       ///< FLIGHT_LAYOUT.
+    uint32_t max_threads;  ///< MAX_THREADS.
+    uint32_t ring_size;    ///< RING_SIZE.
+    uint32_t entry_size;   ///< sizeof(Entry).
+    int32_t pid;           ///< Process that wrote the rings.
+};
+
+/**
+ * @struct TCP_FlightRecorder::Ring
+ * @brief One thread's requests, after a 64-byte ring header.
+ */
+struct alignas(64) TCP_FlightRecorder::Ring
+{
+    std::atomic<uint32_t> owned; ///< 1 while a thread records here.
+    uint32_t tid;                ///< Kernel thread ID of the last owner.
+    std::atomic<uint64_t> head;  ///< Requests ever recorded here.
+    char reserved[48];
+    Entry entries[RING_SIZE];
+};
+
+/**
+ * @struct TCP_FlightRecorderThread
+ * @brief The calling thread's ring; released when the thread exits.
+ */
+struct TCP_FlightRecorderThread
+{
+    const void *header = nullptr;
+    TCP_FlightRecorder::Ring *ring = nullptr;
+
+    ~TCP_FlightRecorderThread()
+    {
+        // The entries stay for post-mortem reading until a new thread
+        // claims the ring.
+        if (ring != nullptr)
+        {
+            ring->owned.store(0, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local TCP_FlightRecorderThread tls_ring;
+
+/// @brief Returns the current Unix time in nanoseconds.
+static int64_t nowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+/// @brief Copies `text` into a fixed field, NUL-padded.
+template <std::size_t N>
+static void copyField(char (&field)[N], const std::string &text)
+{
+    std::size_t length = std::min(text.size(), N);
+    std::memcpy(field, text.data(), length);
+    std::memset(field + length, 0, N - length);
+}
+
+TCP_FlightRecorder::TCP_FlightRecorder()
+    : header_(nullptr),
+      size_(0)
+{
+}
+
+TCP_FlightRecorder::~TCP_FlightRecorder()
+{
+    close();
+}
+
+/**
+ * @brief Maps the rings, replacing any mapped before.
+ * @param path File to map, or empty for anonymous memory.
+ * @return True if the rings are mapped.
+ */
+bool TCP_FlightRecorder::open(const std::string &path)
+{
+    static_assert(sizeof(Header) == 64 && sizeof(Ring) % 64 == 0, "unexpected flight layout");
+    close();
+    const std::size_t size = sizeof(Header) + MAX_THREADS * sizeof(Ring);
+    void *mem = MAP_FAILED;
+    if (path.empty())
+    {
+        mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    }
+    else
+    {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+        if (fd < 0)
+        {
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+        {
+            mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+    }
+    if (mem == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // A fresh mapping is zero-filled: every ring is free and empty.
+    Header *header = static_cast<Header *>(mem);
+    header->layout = FLIGHT_LAYOUT;
+    header->max_threads = MAX_THREADS;
+    header->ring_size = RING_SIZE;
+    header->entry_size = sizeof(Entry);
+    header->pid = static_cast<int32_t>(getpid());
+    header->magic = FLIGHT_MAGIC;
+    header_ = header;
+    size_ = size;
+    return true;
+}
+
+/**
+ * @brief Unmaps the rings.
+ */
+void TCP_FlightRecorder::close()
+{
+    if (header_ != nullptr)
+    {
+        munmap(header_, size_);
+        header_ = nullptr;
+    }
+}
+
+TCP_FlightRecorder::Ring *TCP_FlightRecorder::ring(std::size_t index) const
+{
+    return reinterpret_cast<Ring *>(reinterpret_cast<char *>(header_) + sizeof(Header)) + index;
+}
+
+TCP_FlightRecorder::Ring *TCP_FlightRecorder::threadRing()
+{
+    if (tls_ring.header == header_)
+    {
+        return tls_ring.ring;
+    }
+
+    // First request on this thread: claim a free ring, oldest owner first.
+    tls_ring.header = header_;
+    tls_ring.ring = nullptr;
+    for (std::size_t i = 0; i < MAX_THREADS; ++i)
+    {
+        Ring *candidate = ring(i);
+        uint32_t expected = 0;
+        if (candidate->owned.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+        {
+            candidate->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+            tls_ring.ring = candidate;
+            break;
+        }
+    }
+    return tls_ring.ring;
+}
+
+/**
+ * @brief Records the start of a request.
+ * @param session Session ID.
+ * @param command Command name.
+ * @param arg Command argument.
+ * @return The entry to pass to finish(), or nullptr if not recording.
+ */
+TCP_FlightRecorder::Entry *TCP_FlightRecorder::begin(uint64_t session, const std::string &command, const std::string &arg)
+{
+    if (header_ == nullptr)
+    {
+        return nullptr;
+    }
+    Ring *r = threadRing();
+    if (r == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Only this thread writes the ring, so plain loads and stores suffice;
+    // the ordering is for readers in other processes or signal handlers.
+    const uint64_t sequence = r->head.load(std::memory_order_relaxed) + 1;
+    Entry *entry = &r->entries[(sequence - 1) % RING_SIZE];
+    entry->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_release);
+    entry->session = session;
+    entry->start_ns = nowNs();
+    entry->handler_ns = 0;
+    entry->status = 0;
+    entry->done = 0;
+    copyField(entry->command, command);
+    copyField(entry->arg, arg);
+    entry->sequence.store(sequence, std::memory_order_release);
+    r->head.store(sequence, std::memory_order_release);
+    return entry;
+}
+
+/**
+ * @brief Records the end of a request.
+ * @param entry The entry returned by begin(), or nullptr.
+ * @param status Status of the reply.
+ */
+void TCP_FlightRecorder::finish(Entry *entry, TCP_Status status)
+{
+    if (entry == nullptr)
+    {
+        return;
+    }
+    int64_t elapsed = nowNs() - entry->start_ns;
+    entry->handler_ns = static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(elapsed, 1), UINT32_MAX));
+    entry->status = static_cast<uint16_t>(status);
+    std::atomic_signal_fence(std::memory_order_release);
+    entry->done = 1;
+}
+
+/**
+ * @brief Appends a NUL-padded field to a buffer.
+ */
+static char *appendText(char *out, const char *end, const char *text, std::size_t max)
+{
+    for (std::size_t i = 0; i < max && text[i] != '\0' && out < end; ++i)
+    {
+        // Keep one request per line whatever the client sent.
+        *out++ = (text[i] == '\n' || text[i] == '\r') ? ' ' : text[i];
+    }
+    return out;
+}
+
+/**
+ * @brief Appends an unsigned decimal number to a buffer.
+ */
+static char *appendNumber(char *out, const char *end, uint64_t value)
+{
+    char digits[20];
+    int n = 0;
+    do
+    {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (n > 0 && out < end)
+    {
+        *out++ = digits[--n];
+    }
+    return out;
+}
+
+/**
+ * @brief Writes every recorded request to `fd` as text.
+ * @param fd Destination.
+ */
+void TCP_FlightRecorder::dump(int fd) const
+{
+    if (header_ == nullptr)
+    {
+        return;
+    }
+    char line[256];
+    const char *end = line + sizeof(line) - 1;
+    for (std::size_t i = 0; i < MAX_THREADS; ++i)
+    {
+        const Ring *r = ring(i);
+        const uint64_t head = r->head.load(std::memory_order_acquire);
+        const uint64_t first = head > RING_SIZE ? head - RING_SIZE + 1 : 1;
+        for (uint64_t sequence = first; sequence <= head && sequence != 0; ++sequence)
+        {
+            const Entry &entry = r->entries[(sequence - 1) % RING_SIZE];
+            if (entry.sequence.load(std::memory_order_acquire) != sequence)
+            {
+                continue;
+            }
+            // "tid 1234 #17 session 3 start 1760000000123456789 12345 ns status 0 freq 7040100"
+            char *out = line;
+            out = appendText(out, end, "tid ", 4);
+            out = appendNumber(out, end, r->tid);
+            out = appendText(out, end, " #", 2);
+            out = appendNumber(out, end, sequence);
+            out = appendText(out, end, " session ", 9);
+            out = appendNumber(out, end, entry.session);
+            out = appendText(out, end, " start ", 7);
+            out = appendNumber(out, end, static_cast<uint64_t>(entry.start_ns));
+            if (entry.done)
+            {
+                out = appendText(out, end, " ", 1);
+                out = appendNumber(out, end, entry.handler_ns);
+                out = appendText(out, end, " ns status ", 11);
+                out = appendNumber(out, end, entry.status);
+            }
+            else
+            {
+                out = appendText(out, end, " IN FLIGHT", 10);
+            }
+            out = appendText(out, end, " ", 1);
+            out = appendText(out, end, entry.command, sizeof(entry.command));
+            if (entry.arg[0] != '\0')
+            {
+                out = appendText(out, end, " ", 1);
+                out = appendText(out, end, entry.arg, sizeof(entry.arg));
+            }
+            *out++ = '\n';
+            ssize_t written = write(fd, line, static_cast<std::size_t>(out - line));
+            (void)written;
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file tcp_flight_recorder.hpp
+ * @brief Crash-safe record of the most recent requests on every thread.
+ * @details This file defines TCP_FlightRecorder, which keeps the last
+ *          RING_SIZE requests of each serving thread, with the time each
+ *          one started and how long its handler took. Each thread writes
+ *          only to its own ring, so recording takes no lock and no shared
+ *          atomic: a request costs two clock reads and a few small copies.
+ *
+ *          The rings live in a shared mapping, either of a file or of
+ *          anonymous memory. A file survives the process, so after a crash
+ *          `scripts/flight_decode.py` shows what every thread was doing; a
+ *          request that never finished is the one in flight. dump() writes
+ *          the same information and is async-signal-safe, for use in a
+ *          crash signal handler.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_FLIGHT_RECORDER_HPP
+#define TCP_FLIGHT_RECORDER_HPP
+
+// Project includes
+#include "tcp_reply.hpp"
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class TCP_FlightRecorder
+ * @brief Per-thread lock-free rings of recent requests in shared memory.
+ */
+class TCP_FlightRecorder
+{
+public:
+    /// @brief Threads that can record at once; others are not recorded.
+    static constexpr std::size_t MAX_THREADS = 64;
+
+    /// @brief Requests kept per thread (a power of two).
+    static constexpr std::size_t RING_SIZE = 64;
+
+    /**
+     * @struct Entry
+     * @brief One request, exactly 128 bytes.
+     * @details `sequence` is cleared while the entry is rewritten and set
+     *          last, so a reader ignores half-written entries.
+     */
+    struct Entry
+    {
+        std::atomic<uint64_t> sequence; ///< 1-based request number on this ring.
+        uint64_t session;               ///< Session ID.
+        int64_t start_ns;               ///< Unix time the request started, ns.
+        uint32_t handler_ns;            ///< Handler duration; 0 while running.
+        uint16_t status;                ///< TCP_Status of the reply.
+        uint16_t done;                  ///< 1 once the handler returned.
+        char command[16];               ///< Command name, NUL-padded.
+        char arg[80];                   ///< Argument, NUL-padded, truncated.
+    };
+
+    TCP_FlightRecorder();
+    ~TCP_FlightRecorder();
+
+    // Disable copying.
+    TCP_FlightRecorder(const TCP_FlightRecorder &) = delete;
+    TCP_FlightRecorder &operator=(const TCP_FlightRecorder &) = delete;
+
+    /**
+     * @brief Maps the rings, replacing any mapped before.
+     * @details The file is created or truncated; its previous contents
+     *          (e.g. from a crashed run) should be decoded before restarting.
+     *
+     * @param path File to map, or empty for anonymous memory.
+     * @return True if the rings are mapped.
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief Unmaps the rings.
+     * @details Threads must have stopped recording.
+     */
+    void close();
+
+    /**
+     * @brief Records the start of a request on the calling thread's ring.
+     * @param session Session ID.
+     * @param command Command name.
+     * @param arg Command argument.
+     * @return The entry to pass to finish(), or nullptr if not recording.
+     */
+    Entry *begin(uint64_t session, const std::string &command, const std::string &arg);
+
+    /**
+     * @brief Records the end of a request.
+     * @param entry The entry returned by begin(), or nullptr.
+     * @param status Status of the reply.
+     */
+    void finish(Entry *entry, TCP_Status status);
+
+    /**
+     * @brief Writes every recorded request to `fd` as text, oldest first per thread.
+     * @details Async-signal-safe: uses only `write()` and no allocation.
+     *
+     * @param fd Destination, e.g. STDERR_FILENO.
+     */
+    void dump(int fd) const;
+
+private:
+    struct Header;
+    struct Ring;
+
+    /// @brief The mapping: a Header followed by MAX_THREADS rings.
+    Header *header_;
+
+    /// @brief Bytes mapped.
+    std::size_t size_;
+
+    /// @brief Returns ring `index`.
+    Ring *ring(std::size_t index) const;
+
+    /// @brief Returns the calling thread's ring, claiming a free one on first use.
+    Ring *threadRing();
+
+    /// @brief Releases a ring when its thread exits.
+    friend struct TCP_FlightRecorderThread;
+};
+
+#endif // TCP_FLIGHT_RECORDER_HPP
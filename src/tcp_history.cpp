@@ -0,0 +1,86 @@
+/**
+ * @file tcp_history.cpp
+ * @brief Implementation of the parameter history ring buffer.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_history.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <chrono>
+
+TCP_History::TCP_History(std::size_t capacity)
+    : mutex_("history"),
+      samples_(std::max<std::size_t>(capacity, 1)),
+      next_(0),
+      size_(0)
+{
+}
+
+void TCP_History::record(double value)
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    record(std::chrono::duration_cast<std::chrono::milliseconds>(now).count(), value);
+}
+
+void TCP_History::record(int64_t time_ms, double value)
+{
+    std::lock_guard<TCP_Mutex> lock(mutex_);
+    samples_[next_] = Sample{time_ms, value};
+    next_ = (next_ + 1) % samples_.size();
+    size_ = std::min(size_ + 1, samples_.size());
+}
+
+std::vector<TCP_History::Sample> TCP_History::query(std::size_t count, int64_t since_ms, int64_t bucket_ms) const
+{
+    std::vector<Sample> result;
+    {
+        std::lock_guard<TCP_Mutex> lock(mutex_);
+        std::size_t n = size_;
+        if (count > 0)
+        {
+            n = std::min(n, count);
+        }
+        result.reserve(n);
+
+        // Walk back from the newest sample, then put them in time order.
+        std::size_t index = next_;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            index = (index + samples_.size() - 1) % samples_.size();
+            if (samples_[index].time_ms < since_ms)
+            {
+                break;
+            }
+            result.push_back(samples_[index]);
+        }
+    }
+    std::reverse(result.begin(), result.end());
+
+    if (bucket_ms <= 0 || result.empty())
+    {
+        return result;
+    }
+
+    // Average each bucket in place; buckets are contiguous in time order.
+    std::size_t out = 0;
+    std::size_t i = 0;
+    while (i < result.size())
+    {
+        const int64_t start = result[i].time_ms - result[i].time_ms % bucket_ms;
+        double total = 0;
+        std::size_t n = 0;
+        for (; i < result.size() && result[i].time_ms < start + bucket_ms; ++i, ++n)
+        {
+            total += result[i].value;
+        }
+        result[out++] = Sample{start, total / static_cast<double>(n)};
+    }
+    result.resize(out);
+    return result;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file tcp_history.hpp
+ * @brief Fixed-size ring buffer of timestamped parameter values.
+ * @details This file defines TCP_History, which keeps the most recent
+ *          values written to one parameter so that a dashboard can fetch
+ *          them with a single `history` command instead of polling. The
+ *          buffer is allocated once; when it is full the oldest sample is
+ *          overwritten.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_HISTORY_HPP
+#define TCP_HISTORY_HPP
+
+// Project includes
+#include "tcp_mutex.hpp"
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class TCP_History
+ * @brief Thread-safe ring buffer of (time, value) samples.
+ */
+class TCP_History
+{
+public:
+    /// @brief One recorded value.
+    struct Sample
+    {
+        int64_t time_ms; ///< Wall-clock time of the write, Unix milliseconds.
+        double value;    ///< The value written.
+    };
+
+    /**
+     * @brief Allocates the buffer.
+     * @param capacity Number of samples kept; at least 1.
+     */
+    explicit TCP_History(std::size_t capacity);
+
+    /**
+     * @brief Records a value at the current time.
+     * @param value The value.
+     */
+    void record(double value);
+
+    /**
+     * @brief Records a value at a given time.
+     * @param time_ms Unix time in milliseconds; should not go backwards.
+     * @param value The value.
+     */
+    void record(int64_t time_ms, double value);
+
+    /**
+     * @brief Copies recent samples, oldest first.
+     * @details `count` and `since_ms` both limit the result; pass 0 to
+     *          disable either. With `bucket_ms` set, samples are averaged
+     *          into buckets of that width, each stamped with the bucket's
+     *          start time.
+     *
+     * @param count Keep at most the newest `count` samples.
+     * @param since_ms Keep only samples at or after this Unix time.
+     * @param bucket_ms Downsampling bucket width in milliseconds.
+     * @return The samples.
+     */
+    std::vector<Sample> query(std::size_t count, int64_t since_ms, int64_t bucket_ms) const;
+
+    /// @brief Returns the number of samples the buffer holds when full.
+    std::size_t capacity() const { return samples_.size(); }
+
+private:
+    mutable TCP_Mutex mutex_;
+    std::vector<Sample> samples_;
+
+    /// @brief Index the next sample is written to.
+    std::size_t next_;
+
+    /// @brief Number of valid samples.
+    std::size_t size_;
+};
+
+#endif // TCP_HISTORY_HPP
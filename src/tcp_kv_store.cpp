@@ -0,0 +1,234 @@
+/**
+ * @file tcp_kv_store.cpp
+ * @brief Implementation of the lock-striped key-value store.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_kv_store.hpp"
+
+// Project includes
+#include "tcp_named_table.hpp"
+
+// Standard Includes
+#include <cstring>
+
+/// @brief Slot states.
+constexpr const uint8_t SLOT_EMPTY = 0;
+constexpr const uint8_t SLOT_FULL = 1;
+constexpr const uint8_t SLOT_DELETED = 2;
+
+/// @brief Slots per stripe before the first insert.
+constexpr const std::size_t INITIAL_CAPACITY = 16;
+
+TCP_KVStore::Key::Key(Key &&other) noexcept
+    : length_(other.length_),
+      storage_(other.storage_)
+{
+    other.length_ = 0;
+}
+
+TCP_KVStore::Key &TCP_KVStore::Key::operator=(Key &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        length_ = other.length_;
+        storage_ = other.storage_;
+        other.length_ = 0;
+    }
+    return *this;
+}
+
+void TCP_KVStore::Key::assign(const char *data, std::size_t length)
+{
+    release();
+    if (length > KEY_INLINE)
+    {
+        storage_.heap = new char[length];
+        std::memcpy(storage_.heap, data, length);
+    }
+    else
+    {
+        std::memcpy(storage_.chars, data, length);
+    }
+    length_ = static_cast<uint16_t>(length);
+}
+
+void TCP_KVStore::Key::release()
+{
+    if (length_ > KEY_INLINE)
+    {
+        delete[] storage_.heap;
+    }
+    length_ = 0;
+}
+
+bool TCP_KVStore::Key::equals(const char *data, std::size_t length) const
+{
+    return length_ == length && std::memcmp(this->data(), data, length) == 0;
+}
+
+TCP_KVStore::TCP_KVStore()
+{
+    for (auto &stripe : stripes_)
+    {
+        stripe.slots.resize(INITIAL_CAPACITY);
+    }
+}
+
+uint64_t TCP_KVStore::hash(const std::string &key)
+{
+    return TCP_NamedTableBase::hashName(key);
+}
+
+TCP_KVStore::Stripe &TCP_KVStore::stripe(uint64_t hash) const
+{
+    // The low bits index within the stripe, so pick it with the high ones.
+    return stripes_[(hash >> 32) % STRIPES];
+}
+
+TCP_KVStore::Slot *TCP_KVStore::find(Stripe &stripe, uint64_t hash, const std::string &key)
+{
+    const std::size_t mask = stripe.slots.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        Slot &slot = stripe.slots[i];
+        if (slot.state == SLOT_EMPTY)
+        {
+            return nullptr;
+        }
+        if (slot.state == SLOT_FULL && slot.hash == hash && slot.key.equals(key.data(), key.size()))
+        {
+            return &slot;
+        }
+    }
+}
+
+TCP_KVStore::Slot *TCP_KVStore::claim(Stripe &stripe, uint64_t hash, const std::string &key)
+{
+    if (Slot *slot = find(stripe, hash, key))
+    {
+        return slot;
+    }
+    if (stripe.live >= MAX_KEYS / STRIPES)
+    {
+        return nullptr;
+    }
+
+    // Keep at most 3/4 of the slots in use, counting tombstones; grow only
+    // if live keys alone would exceed half.
+    if ((stripe.live + stripe.deleted + 1) * 4 > stripe.slots.size() * 3)
+    {
+        std::size_t capacity = stripe.slots.size();
+        if ((stripe.live + 1) * 2 > capacity)
+        {
+            capacity *= 2;
+        }
+        rehash(stripe, capacity);
+    }
+
+    const std::size_t mask = stripe.slots.size() - 1;
+    std::size_t i = hash & mask;
+    while (stripe.slots[i].state == SLOT_FULL)
+    {
+        i = (i + 1) & mask;
+    }
+    Slot &slot = stripe.slots[i];
+    if (slot.state == SLOT_DELETED)
+    {
+        --stripe.deleted;
+    }
+    slot.state = SLOT_FULL;
+    slot.hash = hash;
+    slot.key.assign(key.data(), key.size());
+    slot.length = 0;
+    ++stripe.live;
+    return &slot;
+}
+
+void TCP_KVStore::rehash(Stripe &stripe, std::size_t capacity)
+{
+    std::vector<Slot> old(capacity);
+    old.swap(stripe.slots);
+    stripe.deleted = 0;
+
+    const std::size_t mask = capacity - 1;
+    for (Slot &slot : old)
+    {
+        if (slot.state != SLOT_FULL)
+        {
+            continue;
+        }
+        std::size_t i = slot.hash & mask;
+        while (stripe.slots[i].state != SLOT_EMPTY)
+        {
+            i = (i + 1) & mask;
+        }
+        stripe.slots[i] = std::move(slot);
+    }
+}
+
+bool TCP_KVStore::set(const std::string &key, const std::string &value)
+{
+    if (key.empty() || key.size() > KEY_SIZE || value.size() > VALUE_SIZE)
+    {
+        return false;
+    }
+    const uint64_t h = hash(key);
+    Stripe &s = stripe(h);
+    std::lock_guard<TCP_Mutex> lock(s.mutex);
+    Slot *slot = claim(s, h, key);
+    if (slot == nullptr)
+    {
+        return false;
+    }
+    std::memcpy(slot->value, value.data(), value.size());
+    slot->length = static_cast<uint8_t>(value.size());
+    return true;
+}
+
+bool TCP_KVStore::get(const std::string &key, std::string &value) const
+{
+    const uint64_t h = hash(key);
+    Stripe &s = stripe(h);
+    std::lock_guard<TCP_Mutex> lock(s.mutex);
+    const Slot *slot = find(s, h, key);
+    if (slot == nullptr)
+    {
+        return false;
+    }
+    value.assign(slot->value, slot->length);
+    return true;
+}
+
+bool TCP_KVStore::erase(const std::string &key)
+{
+    const uint64_t h = hash(key);
+    Stripe &s = stripe(h);
+    std::lock_guard<TCP_Mutex> lock(s.mutex);
+    Slot *slot = find(s, h, key);
+    if (slot == nullptr)
+    {
+        return false;
+    }
+    slot->key.release();
+    slot->state = SLOT_DELETED;
+    --s.live;
+    ++s.deleted;
+    return true;
+}
+
+std::size_t TCP_KVStore::size() const
+{
+    std::size_t total = 0;
+    for (auto &stripe : stripes_)
+    {
+        std::lock_guard<TCP_Mutex> lock(stripe.mutex);
+        total += stripe.live;
+    }
+    return total;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file tcp_kv_store.hpp
+ * @brief In-memory key-value store behind the generic get/set/del commands.
+ * @details This file defines TCP_KVStore, a hash table sized for the short
+ *          names and values our clients store. Keys are hashed to one of
+ *          STRIPES independently locked stripes, each an open-addressing
+ *          table with linear probing. Slots hold short keys and values
+ *          inline, so a lookup touches one or two adjacent slots and makes
+ *          no allocation; only keys longer than KEY_INLINE bytes live on the
+ *          heap.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_KV_STORE_HPP
+#define TCP_KV_STORE_HPP
+
+// Project includes
+#include "tcp_mutex.hpp"
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class TCP_KVStore
+ * @brief Lock-striped open-addressing table of string keys and values.
+ */
+class TCP_KVStore
+{
+public:
+    /// @brief Number of independently locked stripes.
+    static constexpr std::size_t STRIPES = 16;
+
+    /// @brief Longest key stored inside its slot.
+    static constexpr std::size_t KEY_INLINE = 22;
+
+    /// @brief Maximum key length.
+    static constexpr std::size_t KEY_SIZE = 255;
+
+    /// @brief Maximum value length in bytes.
+    static constexpr std::size_t VALUE_SIZE = 64;
+
+    /// @brief Maximum number of keys; each stripe holds MAX_KEYS / STRIPES.
+    static constexpr std::size_t MAX_KEYS = 65536;
+
+    TCP_KVStore();
+
+    // Disable copying.
+    TCP_KVStore(const TCP_KVStore &) = delete;
+    TCP_KVStore &operator=(const TCP_KVStore &) = delete;
+
+    /**
+     * @brief Stores a value, replacing any previous one.
+     * @param key Key, 1 to KEY_SIZE bytes.
+     * @param value Value, at most VALUE_SIZE bytes.
+     * @return False if the key or value is too long, or the key is new
+     *         and its stripe already holds MAX_KEYS / STRIPES keys.
+     */
+    bool set(const std::string &key, const std::string &value);
+
+    /**
+     * @brief Reads a value.
+     * @param key Key.
+     * @param value Receives the value.
+     * @return False if the key is not set.
+     */
+    bool get(const std::string &key, std::string &value) const;
+
+    /**
+     * @brief Removes a key.
+     * @param key Key.
+     * @return False if the key was not set.
+     */
+    bool erase(const std::string &key);
+
+    /**
+     * @brief Counts the keys that are set.
+     * @return Number of keys.
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * @brief Key with small-string optimization.
+     * @details Keys up to KEY_INLINE bytes are stored in place; longer ones
+     *          point to a heap copy.
+     */
+    class Key
+    {
+    public:
+        Key() : length_(0) {}
+        ~Key() { release(); }
+        Key(Key &&other) noexcept;
+        Key &operator=(Key &&other) noexcept;
+        Key(const Key &) = delete;
+        Key &operator=(const Key &) = delete;
+
+        /// @brief Replaces the key's bytes.
+        void assign(const char *data, std::size_t length);
+
+        /// @brief Frees any heap copy and empties the key.
+        void release();
+
+        /// @brief True if the key equals the given bytes.
+        bool equals(const char *data, std::size_t length) const;
+
+    private:
+        const char *data() const { return length_ > KEY_INLINE ? storage_.heap : storage_.chars; }
+
+        uint16_t length_;
+        union
+        {
+            char chars[KEY_INLINE];
+            char *heap;
+        } storage_;
+    };
+
+    /// @brief One table entry.
+    struct Slot
+    {
+        uint64_t hash = 0;  ///< Full hash of the key, compared before the key.
+        Key key;            ///< The key, if `state` is FULL.
+        uint8_t state = 0;  ///< EMPTY, FULL or DELETED.
+        uint8_t length = 0; ///< Bytes used in `value`.
+        char value[VALUE_SIZE];
+    };
+
+    /// @brief One lock and the table it protects, on its own cache line.
+    struct alignas(64) Stripe
+    {
+        TCP_Mutex mutex{"kv"};
+        std::vector<Slot> slots; ///< Power-of-two sized.
+        std::size_t live = 0;    ///< FULL slots.
+        std::size_t deleted = 0; ///< DELETED slots (tombstones).
+    };
+
+    /// @brief The stripes; mutable so const readers can take their locks.
+    mutable Stripe stripes_[STRIPES];
+
+    /// @brief Hashes a key (FNV-1a, as TCP_NamedTable does).
+    static uint64_t hash(const std::string &key);
+
+    /// @brief Returns the stripe for a hash.
+    Stripe &stripe(uint64_t hash) const;
+
+    /**
+     * @brief Finds the slot holding `key`; caller holds the stripe lock.
+     * @return The slot, or nullptr if the key is not set.
+     */
+    static Slot *find(Stripe &stripe, uint64_t hash, const std::string &key);
+
+    /**
+     * @brief Finds or claims the slot for `key`; caller holds the stripe lock.
+     * @return The slot, already marked FULL, or nullptr if the key is new
+     *         and the stripe is full.
+     */
+    static Slot *claim(Stripe &stripe, uint64_t hash, const std::string &key);
+
+    /// @brief Rebuilds a stripe's table with `capacity` slots.
+    static void rehash(Stripe &stripe, std::size_t capacity);
+};
+
+#endif // TCP_KV_STORE_HPP
@@ -0,0 +1,81 @@
+/**
+ * @file tcp_mutex.cpp
+ * @brief Implementation of the instrumented mutex.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_mutex.hpp"
+
+// Standard Includes
+#include <chrono>
+#include <map>
+#include <memory>
+
+/**
+ * @brief Figures by lock name.
+ * @details Names are never removed, and the map is never destroyed, so a
+ *          global mutex may be used during static destruction.
+ */
+static std::mutex &namesMutex()
+{
+    static std::mutex *mutex = new std::mutex;
+    return *mutex;
+}
+
+static std::map<std::string, std::unique_ptr<TCP_Stats>> &names()
+{
+    static auto *stats = new std::map<std::string, std::unique_ptr<TCP_Stats>>;
+    return *stats;
+}
+
+/**
+ * @brief Constructs a mutex.
+ * @param name Lock name in reports.
+ */
+TCP_Mutex::TCP_Mutex(const char *name)
+{
+    std::lock_guard<std::mutex> lock(namesMutex());
+    std::unique_ptr<TCP_Stats> &stats = names()[name];
+    if (!stats)
+    {
+        stats = std::make_unique<TCP_Stats>();
+    }
+    stats_ = stats.get();
+}
+
+/**
+ * @brief Waits for the mutex and records how long it took.
+ */
+void TCP_Mutex::lockContended()
+{
+    auto started = std::chrono::steady_clock::now();
+    mutex_.lock();
+    auto waited = std::chrono::steady_clock::now() - started;
+    stats_->add(ACQUISITIONS);
+    stats_->add(CONTENDED);
+    stats_->record(WAIT_NS, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+}
+
+/**
+ * @brief Returns the figures of every lock name, sorted by name.
+ * @return One report per name.
+ */
+std::vector<TCP_Mutex::Report> TCP_Mutex::report()
+{
+    std::vector<Report> reports;
+    std::lock_guard<std::mutex> lock(namesMutex());
+    for (const auto &entry : names())
+    {
+        Report report;
+        report.name = entry.first;
+        report.acquisitions = entry.second->read(ACQUISITIONS);
+        report.contended = entry.second->read(CONTENDED);
+        report.wait = entry.second->histogram(WAIT_NS);
+        reports.push_back(std::move(report));
+    }
+    return reports;
+}
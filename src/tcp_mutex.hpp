@@ -0,0 +1,112 @@
+/**
+ * @file tcp_mutex.hpp
+ * @brief A mutex that counts its acquisitions, contention and wait time.
+ * @details This file defines TCP_Mutex, a drop-in replacement for
+ *          `std::mutex` (it works with `std::lock_guard` and
+ *          `std::unique_lock`; wait on it with `std::condition_variable_any`).
+ *          Every mutex has a name, and all mutexes with the same name share
+ *          one set of figures: acquisitions, acquisitions that had to wait,
+ *          and a histogram of the wait in nanoseconds.
+ *
+ *          An uncontended lock() is a `try_lock()` and one per-thread
+ *          counter update (TCP_Stats); the clock is read only when the
+ *          lock is already held, so the cost is paid where there is
+ *          waiting anyway.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_MUTEX_HPP
+#define TCP_MUTEX_HPP
+
+// Project includes
+#include "tcp_stats.hpp"
+
+// Standard includes
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class TCP_Mutex
+ * @brief A named, instrumented `std::mutex`.
+ */
+class TCP_Mutex
+{
+public:
+    /**
+     * @struct Report
+     * @brief Figures of all mutexes sharing one name.
+     */
+    struct Report
+    {
+        std::string name;           ///< Lock name.
+        int64_t acquisitions = 0;   ///< Successful lock() and try_lock() calls.
+        int64_t contended = 0;      ///< lock() calls that had to wait.
+        TCP_Stats::Histogram wait;  ///< Wait of the contended calls, ns.
+    };
+
+    /**
+     * @brief Constructs a mutex.
+     * @param name Lock name in reports, e.g. "server".
+     */
+    explicit TCP_Mutex(const char *name);
+
+    // Disable copying.
+    TCP_Mutex(const TCP_Mutex &) = delete;
+    TCP_Mutex &operator=(const TCP_Mutex &) = delete;
+
+    /// @brief Locks the mutex, timing the wait if it is held.
+    void lock()
+    {
+        if (!mutex_.try_lock())
+        {
+            lockContended();
+            return;
+        }
+        stats_->add(ACQUISITIONS);
+    }
+
+    /// @brief Locks the mutex if it is free.
+    bool try_lock()
+    {
+        if (!mutex_.try_lock())
+        {
+            return false;
+        }
+        stats_->add(ACQUISITIONS);
+        return true;
+    }
+
+    /// @brief Unlocks the mutex.
+    void unlock() { mutex_.unlock(); }
+
+    /**
+     * @brief Returns the figures of every lock name, sorted by name.
+     * @return One report per name.
+     */
+    static std::vector<Report> report();
+
+private:
+    /// @brief Counter and histogram indexes in a name's TCP_Stats.
+    enum : std::size_t
+    {
+        ACQUISITIONS = 0,
+        CONTENDED = 1,
+        WAIT_NS = 0
+    };
+
+    std::mutex mutex_;
+
+    /// @brief Figures shared by every mutex with this name.
+    TCP_Stats *stats_;
+
+    /// @brief Slow path of lock(): waits and records how long.
+    void lockContended();
+};
+
+#endif // TCP_MUTEX_HPP
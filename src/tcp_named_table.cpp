@@ -0,0 +1,36 @@
+/**
+ * @file tcp_named_table.cpp
+ * @brief Implementation of the name hashing and shard selection.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_named_table.hpp"
+
+// System Includes
+#include <sched.h>
+
+/**
+ * @brief Hashes a name (FNV-1a).
+ */
+uint64_t TCP_NamedTableBase::hashName(const std::string &name)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : name)
+    {
+        hash = (hash ^ c) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Returns the shard for the calling thread's current CPU.
+ */
+std::size_t TCP_NamedTableBase::currentShard()
+{
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : static_cast<std::size_t>(cpu) % SHARDS;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file tcp_named_table.hpp
+ * @brief Fixed-capacity table of named entries sharded per CPU.
+ * @details This file defines TCP_NamedTable, the storage behind
+ *          TCP_Counters and TCP_CommandCosts. Each entry has a name and an
+ *          array of SHARDS per-CPU shards; an update goes to the shard of
+ *          the CPU it runs on, so threads on different cores updating the
+ *          same entry do not bounce one cache line between them, and reads
+ *          sum the shards.
+ *
+ *          Entries are created on first use and never removed. Looking an
+ *          entry up takes no lock; only creating one does.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_NAMED_TABLE_HPP
+#define TCP_NAMED_TABLE_HPP
+
+// Project includes
+#include "tcp_mutex.hpp"
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/**
+ * @class TCP_NamedTableBase
+ * @brief The parts of TCP_NamedTable that do not depend on its entries.
+ */
+class TCP_NamedTableBase
+{
+public:
+    /// @brief Shards per entry; CPUs beyond this share shards.
+    static constexpr std::size_t SHARDS = 16;
+
+    /// @brief Longest entry name.
+    static constexpr std::size_t NAME_SIZE = 31;
+
+    /**
+     * @brief Hashes a name (FNV-1a).
+     * @details Also used by TCP_KVStore for its keys.
+     */
+    static uint64_t hashName(const std::string &name);
+
+    /// @brief Returns the shard for the calling thread's current CPU.
+    static std::size_t currentShard();
+};
+
+/**
+ * @class TCP_NamedTable
+ * @brief Up to `Capacity` named entries of SHARDS `Shard`s each.
+ *
+ * @tparam Shard Per-CPU data of one entry; declare it `alignas(64)` so
+ *               each shard has its own cache line.
+ * @tparam Capacity Maximum number of entries.
+ */
+template <typename Shard, std::size_t Capacity>
+class TCP_NamedTable : public TCP_NamedTableBase
+{
+public:
+    /**
+     * @struct Entry
+     * @brief A name and its shards.
+     */
+    struct Entry
+    {
+        uint64_t hash = 0;
+        std::string name;
+        Shard shards[SHARDS];
+
+        /// @brief Returns the shard for the calling thread's current CPU.
+        Shard &local() { return shards[currentShard()]; }
+    };
+
+    /**
+     * @brief Constructs an empty table.
+     * @param lock_name Name of the creation lock, for lock profiling.
+     */
+    explicit TCP_NamedTable(const char *lock_name)
+        : count_(0),
+          create_mutex_(lock_name)
+    {
+        for (auto &entry : table_)
+        {
+            entry.store(nullptr, std::memory_order_relaxed);
+        }
+        for (auto &entry : order_)
+        {
+            entry.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~TCP_NamedTable()
+    {
+        for (auto &entry : order_)
+        {
+            delete entry.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Disable copying.
+    TCP_NamedTable(const TCP_NamedTable &) = delete;
+    TCP_NamedTable &operator=(const TCP_NamedTable &) = delete;
+
+    /**
+     * @brief Finds an entry without locking.
+     * @return The entry, or nullptr if it does not exist.
+     */
+    Entry *find(const std::string &name) const
+    {
+        return probe(hashName(name), name).first;
+    }
+
+    /**
+     * @brief Finds an entry, creating it on first use.
+     * @return The entry, or nullptr if the name is empty or longer than
+     *         NAME_SIZE, or Capacity entries already exist.
+     */
+    Entry *findOrCreate(const std::string &name)
+    {
+        const uint64_t hash = hashName(name);
+        if (Entry *entry = probe(hash, name).first)
+        {
+            return entry;
+        }
+        if (name.empty() || name.size() > NAME_SIZE)
+        {
+            return nullptr;
+        }
+
+        // Probe again under the lock: another thread may have just created it.
+        std::lock_guard<TCP_Mutex> lock(create_mutex_);
+        auto found = probe(hash, name);
+        if (found.first != nullptr)
+        {
+            return found.first;
+        }
+        const std::size_t index = count_.load(std::memory_order_relaxed);
+        if (index >= Capacity)
+        {
+            return nullptr;
+        }
+        Entry *entry = new Entry();
+        entry->hash = hash;
+        entry->name = name;
+        order_[index].store(entry, std::memory_order_release);
+        count_.store(index + 1, std::memory_order_release);
+        table_[found.second].store(entry, std::memory_order_release);
+        return entry;
+    }
+
+    /// @brief Returns the number of entries created.
+    std::size_t size() const { return count_.load(std::memory_order_acquire); }
+
+    /// @brief Returns an entry by creation order; `index` < size().
+    const Entry &at(std::size_t index) const { return *order_[index].load(std::memory_order_acquire); }
+
+private:
+    /// @brief Open-addressing index; entries are set once and never cleared.
+    static constexpr std::size_t TABLE_SIZE = Capacity * 2;
+
+    std::atomic<Entry *> table_[TABLE_SIZE];
+
+    /// @brief Entries in creation order.
+    std::atomic<Entry *> order_[Capacity];
+
+    /// @brief Number of entries created.
+    std::atomic<std::size_t> count_;
+
+    /// @brief Serializes entry creation.
+    TCP_Mutex create_mutex_;
+
+    /**
+     * @brief Looks a name up in the index.
+     * @return The entry, or nullptr and the free index slot that ends its
+     *         probe sequence.
+     */
+    std::pair<Entry *, std::size_t> probe(uint64_t hash, const std::string &name) const
+    {
+        for (std::size_t i = hash % TABLE_SIZE;; i = (i + 1) % TABLE_SIZE)
+        {
+            Entry *entry = table_[i].load(std::memory_order_acquire);
+            if (entry == nullptr)
+            {
+                return {nullptr, i};
+            }
+            if (entry->hash == hash && entry->name == name)
+            {
+                return {entry, i};
+            }
+        }
+    }
+};
+
+#endif // TCP_NAMED_TABLE_HPP
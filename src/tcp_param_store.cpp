@@ -0,0 +1,453 @@
+/**
+ * @file tcp_param_store.cpp
+ * @brief Implementation of the shared-memory parameter store.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_param_store.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+// System Includes
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @brief Identifies an initialized segment ("TCPPARAM").
+constexpr const uint64_t SEGMENT_MAGIC = 0x4D41524150504354ULL;
+
+/// @brief Bumped whenever the segment layout changes.
+constexpr const uint32_t SEGMENT_LAYOUT = 2;
+
+/// @brief How long a slot may stay mid-write before its writer is checked on.
+constexpr const auto STALE_WRITE_TIMEOUT = std::chrono::milliseconds(100);
+
+/// @brief Pause between checks on a stalled writer that is still alive.
+constexpr const auto STALLED_WRITER_POLL = std::chrono::milliseconds(1);
+
+/**
+ * @class StallWatch
+ * @brief Notices a slot word that a writer left mid-update.
+ * @details A write holds a slot for a few dozen instructions, so a
+ *          sequence number that stays odd (or a state that stays
+ *          "being named") for STALE_WRITE_TIMEOUT belongs to a process
+ *          that died, or was stopped, during the write.
+ */
+class StallWatch
+{
+public:
+    /**
+     * @brief Records the word's current value.
+     * @return True once the same value has been seen for STALE_WRITE_TIMEOUT.
+     */
+    bool stalled(uint64_t value)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (!watching_ || value != value_)
+        {
+            watching_ = true;
+            value_ = value;
+            since_ = now;
+            return false;
+        }
+        return now - since_ >= STALE_WRITE_TIMEOUT;
+    }
+
+private:
+    bool watching_ = false;
+    uint64_t value_ = 0;
+    std::chrono::steady_clock::time_point since_;
+};
+
+/**
+ * @brief Packs a writer's pid and a sequence number into a slot word.
+ */
+static inline uint64_t sequenceWord(uint32_t writer, uint32_t sequence)
+{
+    return static_cast<uint64_t>(writer) << 32 | sequence;
+}
+
+/// @brief Returns the sequence number of a slot word.
+static inline uint32_t sequenceOf(uint64_t word) { return static_cast<uint32_t>(word); }
+
+/// @brief Returns the pid of the last writer recorded in a slot word.
+static inline pid_t writerOf(uint64_t word) { return static_cast<pid_t>(word >> 32); }
+
+/**
+ * @brief Checks whether a writer's process has exited.
+ * @details A process that is only descheduled or stopped still exists and
+ *          may resume its write, so its slot must not be taken over.
+ */
+static bool writerGone(pid_t writer)
+{
+    return writer > 0 && kill(writer, 0) != 0 && errno == ESRCH;
+}
+
+/**
+ * @struct TCP_ParamStore::Segment
+ * @brief Layout of the shared-memory segment.
+ */
+struct TCP_ParamStore::Segment
+{
+    /// @brief A single seqlock-protected parameter.
+    struct alignas(64) Slot
+    {
+        std::atomic<uint32_t> state;    ///< 0 free, 1 being named, 2 named.
+        std::atomic<uint64_t> sequence; ///< Last writer's pid, then a sequence odd while it writes.
+        uint64_t version;               ///< Number of completed writes.
+        uint32_t length;                ///< Bytes used in `value`.
+        char name[NAME_SIZE + 1];       ///< NUL-terminated parameter name.
+        char value[VALUE_SIZE];         ///< Raw value bytes.
+    };
+
+    std::atomic<uint64_t> magic; ///< SEGMENT_MAGIC once initialized.
+    uint32_t layout;             ///< SEGMENT_LAYOUT of the creator.
+    uint32_t slot_count;         ///< SLOT_COUNT of the creator.
+    Slot slots[SLOT_COUNT];
+};
+
+TCP_ParamStore::TCP_ParamStore()
+    : segment_(nullptr),
+      read_only_(false)
+{
+}
+
+TCP_ParamStore::~TCP_ParamStore()
+{
+    close();
+}
+
+/**
+ * @brief Maps a segment, replacing any segment already mapped.
+ * @param name Shared-memory object name, or empty for a private store.
+ * @param read_only Map read-only.
+ * @return True if the segment is mapped and valid.
+ */
+bool TCP_ParamStore::open(const std::string &name, bool read_only)
+{
+    close();
+    read_only_ = read_only;
+    const size_t size = sizeof(Segment);
+    void *mem = MAP_FAILED;
+    bool creator = false;
+
+    if (name.empty())
+    {
+        mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        creator = true;
+    }
+    else
+    {
+        int fd = -1;
+        if (!read_only)
+        {
+            // Exactly one process wins O_EXCL and initializes the segment.
+            fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+            creator = fd >= 0;
+        }
+        if (fd < 0)
+        {
+            fd = shm_open(name.c_str(), read_only ? O_RDONLY : O_RDWR, 0);
+        }
+        if (fd < 0)
+        {
+            return false;
+        }
+        if (creator && ftruncate(fd, size) != 0)
+        {
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        if (!creator)
+        {
+            // Wait briefly for the creator to size the object.
+            struct stat st;
+            for (int i = 0; i < 100 && fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) < size; ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size)
+            {
+                ::close(fd);
+                return false;
+            }
+        }
+        mem = mmap(nullptr, size, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+    }
+    if (mem == MAP_FAILED)
+    {
+        return false;
+    }
+
+    Segment *segment = static_cast<Segment *>(mem);
+    if (creator)
+    {
+        new (segment) Segment{};
+        segment->layout = SEGMENT_LAYOUT;
+        segment->slot_count = SLOT_COUNT;
+        segment->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+    }
+    else
+    {
+        for (int i = 0; i < 100 && segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC ||
+            segment->layout != SEGMENT_LAYOUT || segment->slot_count != SLOT_COUNT)
+        {
+            munmap(mem, size);
+            return false;
+        }
+    }
+    segment_ = segment;
+    return true;
+}
+
+/**
+ * @brief Unmaps the segment.
+ */
+void TCP_ParamStore::close()
+{
+    if (segment_ != nullptr)
+    {
+        munmap(segment_, sizeof(Segment));
+        segment_ = nullptr;
+    }
+}
+
+/**
+ * @brief Removes a shared-memory object from the system.
+ * @param name Shared-memory object name.
+ * @return True if the object was removed.
+ */
+bool TCP_ParamStore::unlink(const std::string &name)
+{
+    return shm_unlink(name.c_str()) == 0;
+}
+
+/**
+ * @brief Finds the slot for `key`, optionally claiming a free one.
+ * @param key Parameter name.
+ * @param create Claim a free slot if the name is not present.
+ * @return Slot index, or -1 if not found or the table is full.
+ */
+int TCP_ParamStore::find(const std::string &key, bool create) const
+{
+    if (segment_ == nullptr || key.empty() || key.size() > NAME_SIZE)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < SLOT_COUNT; ++i)
+    {
+        Segment::Slot &slot = segment_->slots[i];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        StallWatch watch;
+        while (state == 1 && !watch.stalled(state))
+        {
+            // Another process is naming this slot; its name is not final yet.
+            std::this_thread::yield();
+            state = slot.state.load(std::memory_order_acquire);
+        }
+        if (state == 1)
+        {
+            // Its writer died while naming it; the slot is lost.
+            continue;
+        }
+        if (state == 2)
+        {
+            if (key == slot.name)
+            {
+                return static_cast<int>(i);
+            }
+            continue;
+        }
+        if (!create)
+        {
+            return -1;
+        }
+        uint32_t expected = 0;
+        if (slot.state.compare_exchange_strong(expected, 1, std::memory_order_acq_rel))
+        {
+            std::memcpy(slot.name, key.c_str(), key.size() + 1);
+            slot.state.store(2, std::memory_order_release);
+            return static_cast<int>(i);
+        }
+        // Lost the race for this slot; re-examine it as a named slot.
+        --i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Stores a value, creating the slot on first use.
+ * @details Writers from any process serialize on the slot's sequence
+ *          number: it is made odd, together with the writer's pid, before
+ *          the copy and even afterwards. If it stays odd for
+ *          STALE_WRITE_TIMEOUT and the recorded writer's process no longer
+ *          exists, this write takes the slot over and, by completing,
+ *          repairs it for readers. A writer that is merely slow or stopped
+ *          keeps the slot until it finishes. Writers must share a PID
+ *          namespace.
+ *
+ *          The write is published with a compare-and-swap on the word it
+ *          claimed, so a write that was taken over can never make the
+ *          sequence even under the writer that replaced it.
+ *
+ * @param key Parameter name.
+ * @param value New value, at most VALUE_SIZE bytes.
+ * @return False if the store is read-only, the name is invalid, the value
+ *         is too long, all slots are in use, or the write was taken over.
+ */
+bool TCP_ParamStore::set(const std::string &key, const std::string &value)
+{
+    if (read_only_ || value.size() > VALUE_SIZE)
+    {
+        return false;
+    }
+    int index = find(key, true);
+    if (index < 0)
+    {
+        return false;
+    }
+    Segment::Slot &slot = segment_->slots[index];
+
+    // Make the sequence odd under our pid; `word` ends up holding the word we own.
+    const uint32_t self = static_cast<uint32_t>(getpid());
+    uint64_t word = slot.sequence.load(std::memory_order_relaxed);
+    StallWatch watch;
+    while (true)
+    {
+        const uint32_t sequence = sequenceOf(word);
+        if ((sequence & 1) == 0)
+        {
+            const uint64_t claimed = sequenceWord(self, sequence + 1);
+            if (slot.sequence.compare_exchange_weak(word, claimed, std::memory_order_acquire))
+            {
+                word = claimed;
+                break;
+            }
+            continue;
+        }
+        if (watch.stalled(word))
+        {
+            if (writerGone(writerOf(word)))
+            {
+                // Take over from the dead writer; the sequence stays odd.
+                const uint64_t claimed = sequenceWord(self, sequence + 2);
+                if (slot.sequence.compare_exchange_strong(word, claimed, std::memory_order_acquire))
+                {
+                    word = claimed;
+                    break;
+                }
+                continue;
+            }
+            std::this_thread::sleep_for(STALLED_WRITER_POLL);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+        word = slot.sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.length = static_cast<uint32_t>(value.size());
+    std::memcpy(slot.value, value.data(), slot.length);
+    ++slot.version;
+
+    // Publish only if the slot is still ours.
+    return slot.sequence.compare_exchange_strong(word, sequenceWord(self, sequenceOf(word) + 1),
+                                                 std::memory_order_release, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reads a consistent copy of a value.
+ * @param key Parameter name.
+ * @param value Receives the value.
+ * @param version If not null, receives the slot's write count.
+ * @return False if the parameter has never been set, or if its last
+ *         writer died mid-update and no write has repaired it since.
+ */
+bool TCP_ParamStore::get(const std::string &key, std::string &value, uint64_t *version) const
+{
+    int index = find(key, false);
+    if (index < 0)
+    {
+        return false;
+    }
+    const Segment::Slot &slot = segment_->slots[index];
+
+    char buffer[VALUE_SIZE];
+    uint32_t length;
+    uint64_t slot_version;
+    StallWatch watch;
+    while (true)
+    {
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if ((sequenceOf(before) & 1) != 0)
+        {
+            if (watch.stalled(before))
+            {
+                return false;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        length = std::min<uint32_t>(slot.length, VALUE_SIZE);
+        std::memcpy(buffer, slot.value, length);
+        slot_version = slot.version;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before)
+        {
+            break;
+        }
+    }
+    if (slot_version == 0)
+    {
+        return false;
+    }
+    value.assign(buffer, length);
+    if (version != nullptr)
+    {
+        *version = slot_version;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads every parameter that has been set.
+ * @return Name/value pairs in slot order.
+ */
+std::vector<std::pair<std::string, std::string>> TCP_ParamStore::snapshot() const
+{
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (size_t i = 0; segment_ != nullptr && i < SLOT_COUNT; ++i)
+    {
+        const Segment::Slot &slot = segment_->slots[i];
+        if (slot.state.load(std::memory_order_acquire) != 2)
+        {
+            continue;
+        }
+        std::string value;
+        if (get(slot.name, value))
+        {
+            entries.emplace_back(slot.name, std::move(value));
+        }
+    }
+    return entries;
+}
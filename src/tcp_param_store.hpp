@@ -0,0 +1,133 @@
+/**
+ * @file tcp_param_store.hpp
+ * @brief Parameter store in a POSIX shared-memory segment.
+ * @details This file defines TCP_ParamStore, a fixed-size table of named
+ *          string parameters (e.g. `freq`, `power`, `call`) that can be
+ *          shared by several server processes and read by other programs
+ *          without a TCP round trip. Each slot is protected by a seqlock:
+ *          readers never block writers and retry only if a write overlapped
+ *          their copy. Every slot also carries a version counter that is
+ *          incremented on each write. A slot left mid-write by a process
+ *          that died is detected after a short timeout: readers stop
+ *          waiting for it, and the next write repairs it once it confirms
+ *          the writer's process is gone.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_PARAM_STORE_HPP
+#define TCP_PARAM_STORE_HPP
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class TCP_ParamStore
+ * @brief Seqlock-protected name/value slots in shared memory.
+ */
+class TCP_ParamStore
+{
+public:
+    /// @brief Number of parameter slots in a segment.
+    static constexpr std::size_t SLOT_COUNT = 32;
+
+    /// @brief Maximum parameter name length, excluding the terminator.
+    static constexpr std::size_t NAME_SIZE = 15;
+
+    /// @brief Maximum parameter value length in bytes.
+    static constexpr std::size_t VALUE_SIZE = 64;
+
+    TCP_ParamStore();
+    ~TCP_ParamStore();
+
+    // Disable copying.
+    TCP_ParamStore(const TCP_ParamStore &) = delete;
+    TCP_ParamStore &operator=(const TCP_ParamStore &) = delete;
+
+    /**
+     * @brief Maps a segment, replacing any segment already mapped.
+     * @details With an empty name the segment is private to this process.
+     *          Otherwise the POSIX shared-memory object `name` (e.g.
+     *          `/tcp-server.31415.params`) is created if needed and initialized
+     *          by whichever process creates it.
+     *
+     * @param name Shared-memory object name, or empty for a private store.
+     * @param read_only Map read-only; `set()` then always fails.
+     * @return True if the segment is mapped and valid.
+     */
+    bool open(const std::string &name, bool read_only = false);
+
+    /**
+     * @brief Unmaps the segment. The shared-memory object is kept.
+     */
+    void close();
+
+    /**
+     * @brief Removes a shared-memory object from the system.
+     * @param name Shared-memory object name.
+     * @return True if the object was removed.
+     */
+    static bool unlink(const std::string &name);
+
+    /**
+     * @brief Stores a value, creating the slot on first use.
+     *
+     * @param key Parameter name, at most NAME_SIZE characters.
+     * @param value New value, at most VALUE_SIZE bytes.
+     * @return False if the store is read-only, the name is invalid, the
+     *         value is too long, all slots are in use, or the write was
+     *         taken over because this process looked dead.
+     */
+    bool set(const std::string &key, const std::string &value);
+
+    /**
+     * @brief Reads a consistent copy of a value.
+     *
+     * @param key Parameter name.
+     * @param value Receives the value.
+     * @param version If not null, receives the slot's write count.
+     * @return False if the parameter has never been set, or if its last
+     *         writer died mid-update and no write has repaired it since.
+     */
+    bool get(const std::string &key, std::string &value, uint64_t *version = nullptr) const;
+
+    /**
+     * @brief Reads every parameter that has been set.
+     * @details Each value is individually consistent; the set as a whole
+     *          is not an atomic snapshot if writers are active.
+     *
+     * @return Name/value pairs in slot order.
+     */
+    std::vector<std::pair<std::string, std::string>> snapshot() const;
+
+    /**
+     * @brief Checks whether a segment is mapped.
+     * @return True if open() succeeded.
+     */
+    bool isOpen() const { return segment_ != nullptr; }
+
+private:
+    struct Segment;
+
+    /// @brief The mapped segment.
+    Segment *segment_;
+
+    /// @brief True if the mapping is read-only.
+    bool read_only_;
+
+    /**
+     * @brief Finds the slot for `key`, optionally claiming a free one.
+     * @return Slot index, or -1 if not found or the table is full.
+     */
+    int find(const std::string &key, bool create) const;
+};
+
+#endif // TCP_PARAM_STORE_HPP
@@ -0,0 +1,290 @@
+/**
+ * @file tcp_plugin_handler.cpp
+ * @brief Implementation of the hot-swappable plugin handler.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_plugin_handler.hpp"
+
+// Standard Includes
+#include <cstdlib>
+#include <fstream>
+
+// System Includes
+#include <dlfcn.h>
+#include <unistd.h>
+
+/**
+ * @struct TCP_PluginHandler::Plugin
+ * @brief One loaded shared object and the handler it created.
+ * @details Destroyed when the last command using it returns.
+ */
+struct TCP_PluginHandler::Plugin
+{
+    using Destroy = void (*)(TCP_CommandHandler *);
+
+    void *library = nullptr;
+    TCP_CommandHandler *handler = nullptr;
+    Destroy destroy = nullptr;
+
+    ~Plugin()
+    {
+        if (handler != nullptr)
+        {
+            destroy(handler);
+        }
+        if (library != nullptr)
+        {
+            dlclose(library);
+        }
+    }
+};
+
+/**
+ * @brief Copies a shared object to a new temporary file.
+ * @details glibc returns the already-loaded library for a path it has
+ *          seen, so each load needs a path of its own.
+ *
+ * @param path The shared object.
+ * @param copy Receives the temporary path.
+ * @return False if the copy failed.
+ */
+static bool copyLibrary(const std::string &path, std::string &copy)
+{
+    char name[] = "/tmp/tcp-plugin-XXXXXX.so";
+    int fd = mkstemps(name, 3);
+    if (fd < 0)
+    {
+        return false;
+    }
+    ::close(fd);
+    copy = name;
+
+    std::ifstream in(path, std::ios::binary);
+    std::ofstream out(copy, std::ios::binary | std::ios::trunc);
+    out << in.rdbuf();
+    if (!in || !out)
+    {
+        ::unlink(copy.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads a plugin and makes it current.
+ * @param path Path of the shared object.
+ * @param error Receives the reason on failure.
+ * @return True if the plugin was loaded.
+ */
+bool TCP_PluginHandler::load(const std::string &path, std::string &error)
+{
+    std::string copy;
+    if (!copyLibrary(path, copy))
+    {
+        error = "Unable to read " + path;
+        return false;
+    }
+
+    auto plugin = std::make_shared<Plugin>();
+    plugin->library = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+    // The mapping keeps the code; the file is no longer needed.
+    ::unlink(copy.c_str());
+    if (plugin->library == nullptr)
+    {
+        error = dlerror();
+        return false;
+    }
+
+    auto abi = reinterpret_cast<int (*)()>(dlsym(plugin->library, "tcp_plugin_abi"));
+    auto create = reinterpret_cast<TCP_CommandHandler *(*)()>(dlsym(plugin->library, "tcp_plugin_create"));
+    plugin->destroy = reinterpret_cast<Plugin::Destroy>(dlsym(plugin->library, "tcp_plugin_destroy"));
+    if (abi == nullptr || create == nullptr || plugin->destroy == nullptr)
+    {
+        error = path + " does not export the plugin functions (TCP_PLUGIN_EXPORT)";
+        return false;
+    }
+    if (abi() != TCP_PLUGIN_ABI)
+    {
+        error = path + " was built for plugin ABI " + std::to_string(abi()) +
+                ", expected " + std::to_string(TCP_PLUGIN_ABI);
+        return false;
+    }
+    plugin->handler = create();
+    if (plugin->handler == nullptr)
+    {
+        error = path + " failed to create its handler";
+        return false;
+    }
+
+    std::unordered_set<std::string> commands = plugin->handler->getValidCommands();
+    commands.insert("plugin");
+    commands.insert("auth");
+
+    // Commands already running keep their reference to the old plugin.
+    std::lock_guard<TCP_Mutex> lock(mutex_);
+    current_ = std::move(plugin);
+    path_ = path;
+    ++generation_;
+    command_sets_.push_back(std::move(commands));
+    return true;
+}
+
+/**
+ * @brief Loads the current plugin's path again.
+ * @param error Receives the reason on failure.
+ * @return True if the plugin was reloaded.
+ */
+bool TCP_PluginHandler::reload(std::string &error)
+{
+    std::string path;
+    {
+        std::lock_guard<TCP_Mutex> lock(mutex_);
+        path = path_;
+    }
+    if (path.empty())
+    {
+        error = "No plugin loaded";
+        return false;
+    }
+    return load(path, error);
+}
+
+/**
+ * @brief Returns the number of plugins loaded so far.
+ */
+uint64_t TCP_PluginHandler::generation() const
+{
+    std::lock_guard<TCP_Mutex> lock(mutex_);
+    return generation_;
+}
+
+/**
+ * @brief Returns a reference to the current plugin.
+ */
+std::shared_ptr<TCP_PluginHandler::Plugin> TCP_PluginHandler::current() const
+{
+    std::lock_guard<TCP_Mutex> lock(mutex_);
+    return current_;
+}
+
+/**
+ * @brief Forwards a command to the current plugin.
+ * @param command The command.
+ * @param arg The argument.
+ * @return Response string.
+ */
+std::string TCP_PluginHandler::handleCommand(const std::string &command, const std::string &arg)
+{
+    TCP_Session session;
+    std::string reply = handleCommand(session, command, arg);
+    if (session.failed())
+    {
+        session.renderError(reply);
+    }
+    return reply;
+}
+
+/**
+ * @brief Forwards a command and its session to the current plugin.
+ * @param session State of the client connection.
+ * @param command The command.
+ * @param arg The argument.
+ * @return Response string.
+ */
+std::string TCP_PluginHandler::handleCommand(TCP_Session &session, const std::string &command, const std::string &arg)
+{
+    if (command == "plugin")
+    {
+        return handlePlugin(session, arg);
+    }
+    if (command == "auth")
+    {
+        if (!session.authenticate(admin_token_, arg))
+        {
+            // Never echo the attempted token.
+            session.fail(TCP_Status::NOT_PERMITTED, "auth");
+            return std::string();
+        }
+        return session.terse() ? TCP_Reply::status(TCP_Status::OK) : "Authenticated";
+    }
+    std::shared_ptr<Plugin> plugin = current();
+    if (!plugin)
+    {
+        session.fail(TCP_Status::UNKNOWN_COMMAND, command);
+        return std::string();
+    }
+    return plugin->handler->handleCommand(session, command, arg);
+}
+
+/**
+ * @brief Tells the current plugin that a client connection closed.
+ * @param session State of the connection that closed.
+ */
+void TCP_PluginHandler::sessionClosed(TCP_Session &session)
+{
+    std::shared_ptr<Plugin> plugin = current();
+    if (plugin)
+    {
+        plugin->handler->sessionClosed(session);
+    }
+}
+
+/**
+ * @brief Forwards a command to the current plugin.
+ * @param command The command.
+ * @param arg The argument.
+ * @return Response string.
+ */
+std::string TCP_PluginHandler::processCommand(const std::string &command, const std::string &arg)
+{
+    return handleCommand(command, arg);
+}
+
+/**
+ * @brief Retrieves the current plugin's commands, plus `plugin` and `auth`.
+ * @return A set containing valid command strings.
+ */
+const std::unordered_set<std::string> &TCP_PluginHandler::getValidCommands() const
+{
+    static const std::unordered_set<std::string> none = {"plugin", "auth"};
+    std::lock_guard<TCP_Mutex> lock(mutex_);
+    return command_sets_.empty() ? none : command_sets_.back();
+}
+
+/**
+ * @brief Handles the `plugin` command.
+ * @param session State of the client connection.
+ * @param arg Empty, or "reload" (needs an authenticated session).
+ * @return Response string.
+ */
+std::string TCP_PluginHandler::handlePlugin(TCP_Session &session, const std::string &arg)
+{
+    if (arg == "reload" && !session.admin())
+    {
+        session.fail(TCP_Status::NOT_PERMITTED, "plugin reload");
+        return std::string();
+    }
+    if (arg == "reload")
+    {
+        std::string error;
+        if (!reload(error))
+        {
+            // Not an interned error: the reason is the useful part.
+            return session.terse() ? TCP_Reply::status(TCP_Status::STORE_FAILED) : "ERROR: " + error + ".";
+        }
+    }
+    else if (!arg.empty())
+    {
+        session.fail(TCP_Status::INVALID_ARGUMENT, arg);
+        return std::string();
+    }
+
+    std::lock_guard<TCP_Mutex> lock(mutex_);
+    std::string summary = (path_.empty() ? "none" : path_) + " generation " + std::to_string(generation_);
+    return session.terse() ? TCP_Reply::value(summary) : "Plugin " + summary;
+}
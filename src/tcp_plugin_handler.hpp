@@ -0,0 +1,170 @@
+/**
+ * @file tcp_plugin_handler.hpp
+ * @brief Command handler that serves a handler loaded from a shared object.
+ * @details This file defines TCP_PluginHandler, which loads a
+ *          TCP_CommandHandler implementation with `dlopen()` and forwards
+ *          every command to it. The plugin can be replaced while the server
+ *          runs: each command holds a reference to the plugin it started
+ *          on, so in-flight commands finish on the old version while new
+ *          ones use the new one, and the old shared object is unloaded when
+ *          its last command returns. Clients stay connected throughout.
+ *
+ *          A plugin is a shared object built from a handler class and the
+ *          TCP_PLUGIN_EXPORT macro below. Two commands are handled here and
+ *          never reach the plugin:
+ *          - `plugin` reports the loaded path and generation.
+ *          - `plugin reload` loads the path again (e.g. after a rebuild).
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_PLUGIN_HANDLER_HPP
+#define TCP_PLUGIN_HANDLER_HPP
+
+// Project includes
+#include "tcp_command_interface.hpp"
+#include "tcp_mutex.hpp"
+
+// Standard includes
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+/// @brief Bumped whenever TCP_CommandHandler or TCP_Session change layout.
+constexpr const int TCP_PLUGIN_ABI = 3;
+
+/**
+ * @brief Exports the factory functions for a plugin handler class.
+ * @details Use once in the plugin's source file, e.g.
+ *          `TCP_PLUGIN_EXPORT(MyCommands)`. The class must be default
+ *          constructible.
+ */
+#define TCP_PLUGIN_EXPORT(HandlerClass)                                               \
+    extern "C" int tcp_plugin_abi() { return TCP_PLUGIN_ABI; }                        \
+    extern "C" TCP_CommandHandler *tcp_plugin_create() { return new HandlerClass(); } \
+    extern "C" void tcp_plugin_destroy(TCP_CommandHandler *handler) { delete handler; }
+
+/**
+ * @class TCP_PluginHandler
+ * @brief Forwards commands to a hot-swappable plugin.
+ */
+class TCP_PluginHandler : public TCP_CommandHandler
+{
+public:
+    TCP_PluginHandler() = default;
+
+    // Disable copying.
+    TCP_PluginHandler(const TCP_PluginHandler &) = delete;
+    TCP_PluginHandler &operator=(const TCP_PluginHandler &) = delete;
+
+    /**
+     * @brief Loads a plugin and makes it current.
+     * @details The shared object is copied to a private temporary file
+     *          first, so the same path can be loaded again after it is
+     *          rebuilt. On failure the current plugin is kept.
+     *
+     * @param path Path of the shared object.
+     * @param error Receives the reason on failure.
+     * @return True if the plugin was loaded.
+     */
+    bool load(const std::string &path, std::string &error);
+
+    /**
+     * @brief Loads the current plugin's path again.
+     * @param error Receives the reason on failure.
+     * @return True if the plugin was reloaded.
+     */
+    bool reload(std::string &error);
+
+    /**
+     * @brief Sets the token `auth` checks before allowing `plugin reload`.
+     * @details `auth` is answered here for every plugin, so a session
+     *          authenticated once may use the admin commands of the
+     *          plugin's handler too. With no token, reloading is disabled.
+     *          Must be called before the server starts.
+     *
+     * @param token The token, or empty to disable admin commands.
+     */
+    void setAdminToken(const std::string &token) { admin_token_ = token; }
+
+    /**
+     * @brief Returns the number of plugins loaded so far.
+     * @return 0 until the first successful load().
+     */
+    uint64_t generation() const;
+
+    /**
+     * @brief Forwards a command to the current plugin.
+     * @param command The command.
+     * @param arg The argument.
+     * @return The plugin's reply, or an error if none is loaded.
+     */
+    std::string handleCommand(const std::string &command, const std::string &arg) override;
+
+    /**
+     * @brief Forwards a command and its session to the current plugin.
+     * @param session State of the client connection.
+     * @param command The command.
+     * @param arg The argument.
+     * @return The plugin's reply.
+     */
+    std::string handleCommand(TCP_Session &session, const std::string &command, const std::string &arg) override;
+
+    /**
+     * @brief Retrieves the current plugin's commands, plus `plugin` and `auth`.
+     * @details The returned set stays valid for the life of this handler,
+     *          even after the plugin is replaced.
+     *
+     * @return A set containing valid command strings.
+     */
+    const std::unordered_set<std::string> &getValidCommands() const override;
+
+    /**
+     * @brief Tells the current plugin that a client connection closed.
+     * @param session State of the connection that closed.
+     */
+    void sessionClosed(TCP_Session &session) override;
+
+private:
+    struct Plugin;
+
+    /// @brief Serializes loads and guards `current_`.
+    mutable TCP_Mutex mutex_{"plugin"};
+
+    /// @brief The plugin new commands are sent to.
+    std::shared_ptr<Plugin> current_;
+
+    /// @brief Path of the current plugin.
+    std::string path_;
+
+    /// @brief Number of successful loads.
+    uint64_t generation_ = 0;
+
+    /// @brief Command sets of every version loaded; kept so references stay valid.
+    std::list<std::unordered_set<std::string>> command_sets_;
+
+    /// @brief Token that authenticates clients for admin commands.
+    std::string admin_token_;
+
+    /// @brief Returns a reference to the current plugin.
+    std::shared_ptr<Plugin> current() const;
+
+    /**
+     * @brief Forwards a command to the current plugin.
+     * @param command The command.
+     * @param arg The argument.
+     * @return Response string.
+     */
+    std::string processCommand(const std::string &command, const std::string &arg) override;
+
+    /// @brief Handles the `plugin` command.
+    std::string handlePlugin(TCP_Session &session, const std::string &arg);
+};
+
+#endif // TCP_PLUGIN_HANDLER_HPP
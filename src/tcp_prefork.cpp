@@ -0,0 +1,267 @@
+/**
+ * @file tcp_prefork.cpp
+ * @brief Implementation of the prefork worker supervisor.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_prefork.hpp"
+
+// Standard Includes
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+// System Includes
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/// @brief Minimum delay before a crashed worker is restarted.
+constexpr const auto RESTART_BACKOFF = std::chrono::seconds(1);
+
+/// @brief A worker that exits sooner than this after starting failed at startup.
+constexpr const auto STARTUP_WINDOW = std::chrono::seconds(5);
+
+/// @brief Startup failures in a row after which the supervisor gives up.
+constexpr const int MAX_STARTUP_FAILURES = 5;
+
+/**
+ * @brief Publishes the current server counters into this slot.
+ * @param stats The worker server's current counters.
+ */
+void TCP_WorkerSlot::publish(const TCP_ServerStats &stats)
+{
+    connections.fetch_add(stats.connections - published.connections, std::memory_order_relaxed);
+    commands.fetch_add(stats.commands - published.commands, std::memory_order_relaxed);
+    active.store(stats.active, std::memory_order_relaxed);
+    published = stats;
+}
+
+/**
+ * @brief Creates the shared-memory segment for the worker slots.
+ * @param workers Number of worker processes to keep running.
+ * @param cb Optional event callback.
+ */
+TCP_Prefork::TCP_Prefork(int workers, TCP_ServerCallback cb)
+    : workers_(workers),
+      slots_(nullptr),
+      stopping_(false),
+      callback_(std::move(cb))
+{
+    void *mem = mmap(nullptr, sizeof(TCP_WorkerSlot) * workers_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+        callback(TCP_ServerPriority::ERROR, "Worker slot mmap failed: " + std::string(strerror(errno)), false);
+        return;
+    }
+    slots_ = static_cast<TCP_WorkerSlot *>(mem);
+    for (int i = 0; i < workers_; ++i)
+    {
+        new (&slots_[i]) TCP_WorkerSlot{};
+    }
+}
+
+/**
+ * @brief Releases the shared-memory segment.
+ */
+TCP_Prefork::~TCP_Prefork()
+{
+    if (slots_ != nullptr)
+    {
+        munmap(slots_, sizeof(TCP_WorkerSlot) * workers_);
+    }
+}
+
+void TCP_Prefork::callback(TCP_ServerPriority priority, const std::string &message, bool result)
+{
+    if (callback_)
+        callback_(priority, message, result);
+}
+
+/**
+ * @brief Forks the worker for one slot.
+ * @param index The slot index.
+ * @param worker_main Function run by the child.
+ * @return True if the fork succeeded.
+ */
+bool TCP_Prefork::spawn(int index, const WorkerMain &worker_main)
+{
+    TCP_WorkerSlot &slot = slots_[index];
+    slot.published = TCP_ServerStats{};
+    slot.active.store(0);
+
+    pid_t supervisor = getpid();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        callback(TCP_ServerPriority::ERROR, "Worker fork failed: " + std::string(strerror(errno)), false);
+        return false;
+    }
+    if (pid == 0)
+    {
+        // Die with the supervisor, even if it is killed with SIGKILL; if it
+        // is already gone, the signal would never come.
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+        if (getppid() != supervisor)
+        {
+            std::exit(1);
+        }
+
+        // Child: run the worker and never return into the supervisor loop.
+        // std::exit() runs static destructors so the worker can flush logs.
+        std::exit(worker_main(index, slot));
+    }
+
+    slot.pid.store(pid);
+    callback(TCP_ServerPriority::INFO,
+             "Worker " + std::to_string(index) + " started with pid " + std::to_string(pid), true);
+    return true;
+}
+
+/**
+ * @brief Forks the workers and supervises them until stopped.
+ * @details Workers that exit while the supervisor is running are restarted
+ *          after a short back-off. A worker that exits within
+ *          STARTUP_WINDOW of starting failed at startup (a port in use, a
+ *          bad plugin) and will likely fail again, so after
+ *          MAX_STARTUP_FAILURES of those in a row on one slot the
+ *          supervisor gives up and stops. On stop, every worker receives
+ *          SIGTERM and is reaped before this returns.
+ *
+ * @param worker_main Function run by each worker process.
+ * @return 0 after a clean shutdown, 1 if the segment could not be created
+ *         or a worker kept failing at startup.
+ */
+int TCP_Prefork::run(WorkerMain worker_main)
+{
+    if (slots_ == nullptr)
+    {
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<Clock::time_point> restart_at(workers_, Clock::now());
+    std::vector<Clock::time_point> started_at(workers_, Clock::now());
+    std::vector<int> startup_failures(workers_, 0);
+    std::vector<bool> pending(workers_, true);
+    bool gave_up = false;
+
+    while (!stopping_.load())
+    {
+        // (Re)spawn every slot whose back-off has elapsed.
+        for (int i = 0; i < workers_; ++i)
+        {
+            if (pending[i] && Clock::now() >= restart_at[i])
+            {
+                pending[i] = !spawn(i, worker_main);
+                started_at[i] = Clock::now();
+                restart_at[i] = started_at[i] + RESTART_BACKOFF;
+            }
+        }
+
+        // Reap any worker that exited.
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid <= 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        for (int i = 0; i < workers_; ++i)
+        {
+            if (slots_[i].pid.load() != pid)
+            {
+                continue;
+            }
+            slots_[i].pid.store(0);
+            slots_[i].active.store(0);
+            if (stopping_.load())
+            {
+                break;
+            }
+            std::string how = WIFSIGNALED(status)
+                                  ? "killed by signal " + std::to_string(WTERMSIG(status))
+                                  : "exited with status " + std::to_string(WEXITSTATUS(status));
+            startup_failures[i] = Clock::now() - started_at[i] < STARTUP_WINDOW ? startup_failures[i] + 1 : 0;
+            if (startup_failures[i] >= MAX_STARTUP_FAILURES)
+            {
+                callback(TCP_ServerPriority::ERROR, "Worker " + std::to_string(i) + " " + how + " at startup " +
+                                                        std::to_string(startup_failures[i]) + " times in a row, giving up.",
+                         false);
+                gave_up = true;
+                stopping_.store(true);
+                break;
+            }
+            callback(TCP_ServerPriority::WARN, "Worker " + std::to_string(i) + " " + how + ", restarting.", false);
+            slots_[i].restarts.fetch_add(1);
+            pending[i] = true;
+        }
+    }
+
+    // Stop and reap every remaining worker.
+    for (int i = 0; i < workers_; ++i)
+    {
+        pid_t pid = slots_[i].pid.load();
+        if (pid > 0)
+        {
+            kill(pid, SIGTERM);
+        }
+    }
+    for (int i = 0; i < workers_; ++i)
+    {
+        pid_t pid = slots_[i].pid.load();
+        if (pid > 0)
+        {
+            waitpid(pid, nullptr, 0);
+            slots_[i].pid.store(0);
+            slots_[i].active.store(0);
+        }
+    }
+    callback(TCP_ServerPriority::INFO, "All workers stopped. " + report(), true);
+    return gave_up ? 1 : 0;
+}
+
+/**
+ * @brief Sums the counters of every worker slot.
+ * @return Aggregated statistics across all workers.
+ */
+TCP_ServerStats TCP_Prefork::aggregate() const
+{
+    TCP_ServerStats total;
+    for (int i = 0; slots_ != nullptr && i < workers_; ++i)
+    {
+        total.connections += slots_[i].connections.load(std::memory_order_relaxed);
+        total.commands += slots_[i].commands.load(std::memory_order_relaxed);
+        total.active += slots_[i].active.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Formats the per-worker and total counters for logging.
+ * @return A single-line summary.
+ */
+std::string TCP_Prefork::report() const
+{
+    TCP_ServerStats total = aggregate();
+    std::string line = "Workers: " + std::to_string(workers_) +
+                       ", connections: " + std::to_string(total.connections) +
+                       ", commands: " + std::to_string(total.commands) +
+                       ", active: " + std::to_string(total.active) +
+                       ", restarts:";
+    for (int i = 0; slots_ != nullptr && i < workers_; ++i)
+    {
+        line += " " + std::to_string(slots_[i].restarts.load(std::memory_order_relaxed));
+    }
+    return line;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file tcp_prefork.hpp
+ * @brief Supervisor for prefork multi-process server mode.
+ * @details This file defines TCP_Prefork, which forks a fixed number of
+ *          worker processes that each run their own TCP_Server on the same
+ *          port (the kernel balances connections between them through
+ *          `SO_REUSEPORT`). The supervisor restarts workers that exit
+ *          unexpectedly, gives up on one that keeps failing at startup, and
+ *          aggregates their activity counters through an
+ *          anonymous shared-memory segment created before the first fork.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @note The supervisor must be created and run before any thread is
+ *       started, since only the forking thread survives in the children.
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_PREFORK_HPP
+#define TCP_PREFORK_HPP
+
+// Project includes
+#include "tcp_server.hpp"
+
+// Standard includes
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// System includes
+#include <sys/types.h>
+
+/**
+ * @struct TCP_WorkerSlot
+ * @brief Per-worker record in the shared-memory segment.
+ * @details Written by the worker, read by the supervisor. All fields are
+ *          lock-free atomics so they are valid across processes.
+ */
+struct TCP_WorkerSlot
+{
+    std::atomic<pid_t> pid;            ///< Current worker process, 0 if none.
+    std::atomic<uint32_t> restarts;    ///< Times this slot's worker was restarted.
+    std::atomic<uint64_t> connections; ///< Connections accepted by all incarnations.
+    std::atomic<uint64_t> commands;    ///< Commands handled by all incarnations.
+    std::atomic<int> active;           ///< Connections open in the current worker.
+
+    /**
+     * @brief Publishes the current server counters into this slot.
+     * @details Counters of earlier incarnations are preserved by adding
+     *          the growth since the last publish.
+     *
+     * @param stats The worker server's current counters.
+     */
+    void publish(const TCP_ServerStats &stats);
+
+    /// @brief Values last published by the current incarnation.
+    TCP_ServerStats published;
+};
+
+/**
+ * @class TCP_Prefork
+ * @brief Forks, supervises, and restarts server worker processes.
+ */
+class TCP_Prefork
+{
+public:
+    /// @brief Entry point for a worker; receives its slot, returns an exit code.
+    using WorkerMain = std::function<int(int index, TCP_WorkerSlot &slot)>;
+
+    /**
+     * @brief Creates the shared-memory segment for `workers` slots.
+     * @param workers Number of worker processes to keep running.
+     * @param cb Optional event callback, as for TCP_Server::start().
+     */
+    explicit TCP_Prefork(int workers, TCP_ServerCallback cb = nullptr);
+
+    /**
+     * @brief Releases the shared-memory segment.
+     */
+    ~TCP_Prefork();
+
+    // Disable copying.
+    TCP_Prefork(const TCP_Prefork &) = delete;
+    TCP_Prefork &operator=(const TCP_Prefork &) = delete;
+
+    /**
+     * @brief Forks the workers and supervises them until stopped.
+     * @details In each child, `worker_main` runs and the child exits with
+     *          its return value; this call only returns in the supervisor.
+     *
+     * @param worker_main Function run by each worker process.
+     * @return 0 after a clean shutdown, 1 if the segment could not be created
+     *         or a worker kept failing at startup.
+     */
+    int run(WorkerMain worker_main);
+
+    /**
+     * @brief Asks the supervisor to stop all workers and return.
+     * @details Async-signal-safe; intended to be called from a signal handler.
+     */
+    void requestStop() { stopping_.store(true); }
+
+    /**
+     * @brief Sums the counters of every worker slot.
+     * @return Aggregated statistics across all workers.
+     */
+    TCP_ServerStats aggregate() const;
+
+    /**
+     * @brief Formats the per-worker and total counters for logging.
+     * @return A single-line summary.
+     */
+    std::string report() const;
+
+private:
+    /// @brief Number of worker processes.
+    int workers_;
+
+    /// @brief Shared-memory array of worker slots.
+    TCP_WorkerSlot *slots_;
+
+    /// @brief Set when the supervisor should shut down.
+    std::atomic<bool> stopping_;
+
+    /// @brief Optional event callback.
+    TCP_ServerCallback callback_;
+
+    void callback(TCP_ServerPriority priority, const std::string &message, bool result);
+
+    /**
+     * @brief Forks the worker for one slot.
+     * @return True if the fork succeeded.
+     */
+    bool spawn(int index, const WorkerMain &worker_main);
+};
+
+#endif // TCP_PREFORK_HPP
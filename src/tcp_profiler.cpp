@@ -0,0 +1,343 @@
+/**
+ * @file tcp_profiler.cpp
+ * @brief Implementation of the in-process sampling profiler.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_profiler.hpp"
+
+// Standard Includes
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+// System Includes
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+/// @brief Return addresses below this are not code: the chain has ended.
+constexpr const uintptr_t MIN_CODE_ADDRESS = 4096;
+
+/// @brief Largest distance between two frames accepted as a stack step.
+constexpr const uintptr_t MAX_FRAME_SIZE = 1 << 20;
+
+/**
+ * @struct ProfileSample
+ * @brief One stack, innermost frame first.
+ */
+struct ProfileSample
+{
+    std::atomic<int> depth; ///< Frames captured; 0 until the sample is complete.
+    void *frames[TCP_Profiler::MAX_DEPTH];
+};
+
+/// @brief Sample buffer of the running profile, or nullptr.
+static std::atomic<ProfileSample *> active_samples{nullptr};
+
+/// @brief Slots claimed in active_samples, including dropped ones.
+static std::atomic<std::size_t> next_sample{0};
+
+/// @brief Signal handlers currently running.
+static std::atomic<int> handlers_running{0};
+
+/// @brief Serializes profiles.
+static std::atomic<bool> profiling{false};
+
+/**
+ * @brief Reads the saved frame pointer and return address of a frame.
+ * @details Goes through `process_vm_readv()`, which fails with EFAULT
+ *          instead of faulting when `fp` is not a valid frame (code built
+ *          without frame pointers leaves anything in the register).
+ * @return False if the memory could not be read.
+ */
+static bool readFrame(uintptr_t fp, uintptr_t frame[2])
+{
+    struct iovec local = {frame, 2 * sizeof(uintptr_t)};
+    struct iovec remote = {reinterpret_cast<void *>(fp), 2 * sizeof(uintptr_t)};
+    return process_vm_readv(getpid(), &local, 1, &remote, 1, 0) == static_cast<ssize_t>(2 * sizeof(uintptr_t));
+}
+
+/**
+ * @brief Walks the frame pointer chain of an interrupted thread.
+ * @details On x86-64 and AArch64 each frame starts with the caller's frame
+ *          pointer followed by the return address. On 32-bit ARM, where
+ *          compilers lay frames out differently, only the interrupted
+ *          instruction is recorded.
+ * @return Frames stored in `frames`.
+ */
+static int walkStack(const ucontext_t *context, void **frames, int max_depth)
+{
+#if defined(__x86_64__)
+    uintptr_t pc = static_cast<uintptr_t>(context->uc_mcontext.gregs[REG_RIP]);
+    uintptr_t fp = static_cast<uintptr_t>(context->uc_mcontext.gregs[REG_RBP]);
+#elif defined(__aarch64__)
+    uintptr_t pc = static_cast<uintptr_t>(context->uc_mcontext.pc);
+    uintptr_t fp = static_cast<uintptr_t>(context->uc_mcontext.regs[29]);
+#elif defined(__arm__)
+    uintptr_t pc = static_cast<uintptr_t>(context->uc_mcontext.arm_pc);
+    uintptr_t fp = 0;
+#else
+    (void)context;
+    uintptr_t pc = 0;
+    uintptr_t fp = 0;
+#endif
+    if (pc == 0)
+    {
+        return 0;
+    }
+    int depth = 0;
+    frames[depth++] = reinterpret_cast<void *>(pc);
+
+    // Stacks grow down: each caller's frame must be above the last one.
+    uintptr_t frame[2];
+    while (depth < max_depth && fp != 0 && fp % sizeof(uintptr_t) == 0 && readFrame(fp, frame))
+    {
+        if (frame[1] < MIN_CODE_ADDRESS)
+        {
+            break;
+        }
+        frames[depth++] = reinterpret_cast<void *>(frame[1]);
+        if (frame[0] <= fp || frame[0] - fp > MAX_FRAME_SIZE)
+        {
+            break;
+        }
+        fp = frame[0];
+    }
+    return depth;
+}
+
+/**
+ * @brief SIGPROF handler: records the interrupted thread's stack.
+ * @details Uses only the preallocated buffer and system calls, so it is
+ *          safe whatever the thread was doing, including holding the
+ *          loader or allocator locks.
+ */
+static void onProfileSignal(int, siginfo_t *, void *context)
+{
+    const int saved_errno = errno;
+    // Sequentially consistent with the store and load in profile(): either
+    // profile() sees this handler running or the handler sees nullptr.
+    handlers_running.fetch_add(1, std::memory_order_seq_cst);
+    ProfileSample *samples = active_samples.load(std::memory_order_seq_cst);
+    if (samples != nullptr)
+    {
+        const std::size_t index = next_sample.fetch_add(1, std::memory_order_relaxed);
+        if (index < TCP_Profiler::MAX_SAMPLES)
+        {
+            ProfileSample &sample = samples[index];
+            int depth = walkStack(static_cast<const ucontext_t *>(context), sample.frames,
+                                  static_cast<int>(TCP_Profiler::MAX_DEPTH));
+            sample.depth.store(depth > 0 ? depth : -1, std::memory_order_release);
+        }
+    }
+    handlers_running.fetch_sub(1, std::memory_order_seq_cst);
+    errno = saved_errno;
+}
+
+/**
+ * @brief Names the function containing `address`.
+ * @return The demangled symbol, "module+0xoffset", or an empty string if
+ *         the address is in no loaded module.
+ */
+static std::string symbolize(void *address)
+{
+    Dl_info info;
+    if (dladdr(address, &info) == 0)
+    {
+        return std::string();
+    }
+    std::string name;
+    if (info.dli_sname != nullptr)
+    {
+        int status = 0;
+        std::unique_ptr<char, decltype(&std::free)> demangled(
+            abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), &std::free);
+        name = status == 0 && demangled ? demangled.get() : info.dli_sname;
+    }
+    else
+    {
+        const char *module = info.dli_fname != nullptr ? info.dli_fname : "?";
+        const char *slash = std::strrchr(module, '/');
+        char offset[32];
+        std::snprintf(offset, sizeof(offset), "+0x%zx",
+                      static_cast<std::size_t>(static_cast<char *>(address) - static_cast<char *>(info.dli_fbase)));
+        name = std::string(slash != nullptr ? slash + 1 : module) + offset;
+    }
+
+    // ';' separates frames in the folded format.
+    for (char &c : name)
+    {
+        if (c == ';' || c == '\n')
+        {
+            c = ':';
+        }
+    }
+    return name;
+}
+
+/**
+ * @brief Profiles the whole process, blocking the caller meanwhile.
+ * @param seconds How long to sample.
+ * @param path File that receives the folded stacks; must not exist.
+ * @param result Receives the counts.
+ * @param error Receives the reason on failure.
+ * @return False if another profile is running or the file can't be created.
+ */
+bool TCP_Profiler::profile(unsigned seconds, const std::string &path, Result &result, std::string &error)
+{
+    if (seconds == 0 || seconds > MAX_SECONDS)
+    {
+        error = "duration must be 1 to " + std::to_string(MAX_SECONDS) + " seconds";
+        return false;
+    }
+    bool idle = false;
+    if (!profiling.compare_exchange_strong(idle, true))
+    {
+        error = "a profile is already running";
+        return false;
+    }
+
+    // Never replace an existing file, nor follow a planted link.
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        error = "unable to create " + path + ": " + std::strerror(errno);
+        profiling.store(false);
+        return false;
+    }
+
+    std::unique_ptr<ProfileSample[]> samples(new ProfileSample[MAX_SAMPLES]);
+    for (std::size_t i = 0; i < MAX_SAMPLES; ++i)
+    {
+        samples[i].depth.store(0, std::memory_order_relaxed);
+    }
+    next_sample.store(0, std::memory_order_relaxed);
+    active_samples.store(samples.get(), std::memory_order_seq_cst);
+
+    struct sigaction action, previous;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_sigaction = onProfileSignal;
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &previous);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000 / HZ;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+    // Stop the timer, then wait for handlers still using the buffer.
+    std::memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    active_samples.store(nullptr, std::memory_order_seq_cst);
+    while (handlers_running.load(std::memory_order_seq_cst) != 0)
+    {
+        std::this_thread::yield();
+    }
+    sigaction(SIGPROF, &previous, nullptr);
+
+    // Name each sample's frames, outermost first, and count identical
+    // stacks. Names are cached: most addresses repeat.
+    const std::size_t claimed = next_sample.load(std::memory_order_relaxed);
+    const std::size_t taken = claimed < MAX_SAMPLES ? claimed : MAX_SAMPLES;
+    result = Result();
+    result.dropped = claimed - taken;
+    std::unordered_map<void *, std::string> names;
+    std::map<std::string, std::size_t> stacks;
+    for (std::size_t i = 0; i < taken; ++i)
+    {
+        const int depth = samples[i].depth.load(std::memory_order_acquire);
+        if (depth <= 0)
+        {
+            continue;
+        }
+        // A return address outside every module means the walk followed
+        // a register that was not a frame pointer: the stack ends there.
+        const std::string *frames[MAX_DEPTH];
+        int valid = 0;
+        for (int f = 0; f < depth; ++f)
+        {
+            // Return addresses point after the call; look up the call itself.
+            // The innermost frame is the interrupted instruction.
+            void *address = samples[i].frames[f];
+            void *lookup = f > 0 ? static_cast<char *>(address) - 1 : address;
+            auto name = names.find(lookup);
+            if (name == names.end())
+            {
+                std::string symbol = symbolize(lookup);
+                if (symbol.empty() && f == 0)
+                {
+                    char hex[32];
+                    std::snprintf(hex, sizeof(hex), "%p", address);
+                    symbol = hex;
+                }
+                name = names.emplace(lookup, symbol).first;
+            }
+            if (name->second.empty())
+            {
+                break;
+            }
+            frames[valid++] = &name->second;
+        }
+        std::string line;
+        for (int f = valid - 1; f >= 0; --f)
+        {
+            if (!line.empty())
+            {
+                line += ';';
+            }
+            line += *frames[f];
+        }
+        ++stacks[line];
+        ++result.samples;
+    }
+    profiling.store(false);
+    result.stacks = stacks.size();
+
+    std::string folded;
+    for (const auto &stack : stacks)
+    {
+        folded += stack.first + ' ' + std::to_string(stack.second) + '\n';
+    }
+    std::size_t written = 0;
+    while (written < folded.size())
+    {
+        ssize_t n = ::write(fd, folded.data() + written, folded.size() - written);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    if (::close(fd) != 0 || written < folded.size())
+    {
+        error = "unable to write " + path;
+        return false;
+    }
+    return true;
+}
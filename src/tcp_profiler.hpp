@@ -0,0 +1,89 @@
+/**
+ * @file tcp_profiler.hpp
+ * @brief In-process sampling CPU profiler producing folded stacks.
+ * @details This file defines TCP_Profiler, which samples the call stacks of
+ *          every thread in the process while they use CPU and writes them
+ *          in the "folded" format read by flame graph tools
+ *          (`flamegraph.pl`, speedscope, inferno):
+ *
+ *              main;runServer;BasicTCPServer<...>::handle_client;... 42
+ *
+ *          Sampling uses `setitimer(ITIMER_PROF)`: the kernel sends SIGPROF
+ *          each time the process has used 1/hz seconds of CPU, to a thread
+ *          that is running, so idle threads cost nothing and busy threads
+ *          are sampled in proportion to the CPU they use. The signal
+ *          handler walks the frame pointer chain of the interrupted thread
+ *          into a preallocated buffer, reading each frame through
+ *          `process_vm_readv()` so a bad pointer ends the walk instead of
+ *          crashing; it takes no lock, so it cannot deadlock with `dlopen()`
+ *          or the unwinder. Symbols are resolved after sampling stops.
+ *
+ *          The server is built with `-fno-omit-frame-pointer`; frames in
+ *          libraries built without frame pointers end the stack early.
+ *          Symbol names need the executable to be linked with `-rdynamic`
+ *          (the Makefile does); static functions show as `module+0xoffset`.
+ *
+ *          No external tool or privilege is needed, which makes this usable
+ *          on hosts where attaching `perf` is not allowed.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_PROFILER_HPP
+#define TCP_PROFILER_HPP
+
+// Standard includes
+#include <cstddef>
+#include <string>
+
+/**
+ * @class TCP_Profiler
+ * @brief Samples all threads for a while and writes folded stacks.
+ * @details One profile can run at a time in a process; SIGPROF and
+ *          ITIMER_PROF must not be used by anything else meanwhile.
+ */
+class TCP_Profiler
+{
+public:
+    /// @brief Samples per second of CPU time (not a multiple of common timer rates).
+    static constexpr int HZ = 99;
+
+    /// @brief Samples kept per profile; later ones are dropped.
+    static constexpr std::size_t MAX_SAMPLES = 16384;
+
+    /// @brief Frames kept per sample, innermost first.
+    static constexpr std::size_t MAX_DEPTH = 48;
+
+    /// @brief Longest profile accepted, in seconds.
+    static constexpr unsigned MAX_SECONDS = 300;
+
+    /**
+     * @struct Result
+     * @brief What a profile collected.
+     */
+    struct Result
+    {
+        std::size_t samples = 0; ///< Stacks sampled.
+        std::size_t dropped = 0; ///< Samples lost because the buffer was full.
+        std::size_t stacks = 0;  ///< Distinct stacks written.
+    };
+
+    /**
+     * @brief Profiles the whole process, blocking the caller meanwhile.
+     * @details The calling thread sleeps, so it does not appear in the
+     *          profile itself.
+     *
+     * @param seconds How long to sample, 1 to MAX_SECONDS.
+     * @param path File that receives the folded stacks; it is created and
+     *             must not already exist.
+     * @param result Receives the counts.
+     * @param error Receives the reason on failure.
+     * @return False if another profile is running or the file can't be created.
+     */
+    static bool profile(unsigned seconds, const std::string &path, Result &result, std::string &error);
+};
+
+#endif // TCP_PROFILER_HPP
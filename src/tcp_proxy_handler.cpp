@@ -0,0 +1,355 @@
+/**
+ * @file tcp_proxy_handler.cpp
+ * @brief Implementation of the backend-forwarding command handler.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_proxy_handler.hpp"
+
+// Standard Includes
+#include <cstdlib>
+#include <sstream>
+
+/// @brief Backend commands that act on the connection's session.
+static const std::unordered_set<std::string> SESSION_COMMANDS = {"session", "auth", "subscribe", "unsubscribe", "changes"};
+
+/**
+ * @brief Adopts a protocol the client negotiated with a backend.
+ * @details A client behind the proxy speaks one protocol, so once a backend
+ *          accepted `session protocol ...`, the proxy's own replies and
+ *          re-rendered errors follow it too.
+ */
+static void adoptProtocol(TCP_Session &session, const std::string &line)
+{
+    if (line == "session protocol terse")
+    {
+        session.protocol = TCP_Protocol::TERSE;
+    }
+    else if (line == "session protocol text")
+    {
+        session.protocol = TCP_Protocol::TEXT;
+    }
+}
+
+/**
+ * @brief Adds a backend.
+ * @param name Routing prefix, without the colon.
+ * @param host Backend address.
+ * @param port Backend port.
+ * @param pool_size Maximum connections to this backend.
+ * @return False if the name is empty, reserved, or already used.
+ */
+bool TCP_ProxyHandler::addBackend(const std::string &name, const std::string &host, int port, std::size_t pool_size)
+{
+    if (name.empty() || name == "*" || name.find(':') != std::string::npos || find(name) != backends.size())
+    {
+        return false;
+    }
+    backends.emplace_back(name, std::make_unique<TCP_Client>(host, port, pool_size));
+    valid_commands.insert(name + ":");
+    valid_commands.insert("*:");
+    return true;
+}
+
+/**
+ * @brief Adds backends from a comma-separated `name=host:port` list.
+ * @param spec The backend list.
+ * @return False if any entry is malformed.
+ */
+bool TCP_ProxyHandler::addBackends(const std::string &spec)
+{
+    std::stringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ','))
+    {
+        size_t equals = entry.find('=');
+        size_t colon = entry.rfind(':');
+        if (equals == std::string::npos || colon == std::string::npos || colon < equals)
+        {
+            return false;
+        }
+        int port = std::atoi(entry.c_str() + colon + 1);
+        if (port <= 0 || !addBackend(entry.substr(0, equals), entry.substr(equals + 1, colon - equals - 1), port))
+        {
+            return false;
+        }
+    }
+    return !backends.empty();
+}
+
+/**
+ * @brief Routes a command to its backend(s) over the shared pools.
+ * @param command The prefixed command.
+ * @param arg The argument.
+ * @return Response string, or the error reply.
+ */
+std::string TCP_ProxyHandler::handleCommand(const std::string &command, const std::string &arg)
+{
+    TCP_Session session;
+    std::string reply = route(session, command, arg);
+    if (session.failed())
+    {
+        session.renderError(reply);
+    }
+    return reply;
+}
+
+/**
+ * @brief Routes a command from a client connection.
+ * @param session State of the client connection.
+ * @param command The prefixed command.
+ * @param arg The argument.
+ * @return Response string; errors are reported through `session.fail()`.
+ */
+std::string TCP_ProxyHandler::handleCommand(TCP_Session &session, const std::string &command, const std::string &arg)
+{
+    return route(session, command, arg);
+}
+
+/**
+ * @brief Forwards a command to the backend named by its prefix.
+ * @param command The prefixed command.
+ * @param arg The argument.
+ * @return Response string, or the error reply.
+ */
+std::string TCP_ProxyHandler::processCommand(const std::string &command, const std::string &arg)
+{
+    return handleCommand(command, arg);
+}
+
+/**
+ * @brief Closes the backend connections pinned to a session.
+ * @param session State of the connection that closed.
+ */
+void TCP_ProxyHandler::sessionClosed(TCP_Session &session)
+{
+    std::vector<std::unique_ptr<TCP_Client>> clients;
+    {
+        std::lock_guard<TCP_Mutex> lock(pinned_mutex);
+        auto entry = pinned.find(session.id);
+        if (entry == pinned.end())
+        {
+            return;
+        }
+        clients = std::move(entry->second);
+        pinned.erase(entry);
+    }
+    // The clients close their sockets here, outside the lock.
+}
+
+/**
+ * @brief Routes a command to its backend(s).
+ * @param session The client's session; ID 0 uses the shared pools only.
+ * @param command The prefixed command.
+ * @param arg The argument.
+ * @return Response string; errors are reported through `session.fail()`.
+ */
+std::string TCP_ProxyHandler::route(TCP_Session &session, const std::string &command, const std::string &arg)
+{
+    if (command == "backends")
+    {
+        std::string reply = "Backends:";
+        for (const auto &backend : backends)
+        {
+            reply += " " + backend.first + "=" + backend.second->endpoint();
+        }
+        return reply;
+    }
+
+    // Everything else must name its backend; junk never reaches one.
+    size_t colon = command.find(':');
+    if (colon == std::string::npos || colon + 1 == command.size())
+    {
+        session.fail(TCP_Status::UNKNOWN_COMMAND, command);
+        return std::string();
+    }
+    const std::string target = command.substr(0, colon);
+    std::string line = command.substr(colon + 1);
+    const bool stateful = SESSION_COMMANDS.count(line) != 0;
+    if (stateful && session.id == 0)
+    {
+        // Without a client there is no connection to pin the state to.
+        session.fail(TCP_Status::INVALID_ARGUMENT, command);
+        return std::string();
+    }
+    if (!arg.empty())
+    {
+        line += " " + arg;
+    }
+    if (line.find_first_of("\r\n") != std::string::npos)
+    {
+        // A line break would make the backend answer twice; TCP_Client refuses it.
+        session.fail(TCP_Status::INVALID_ARGUMENT, line);
+        return std::string();
+    }
+
+    if (target == "*")
+    {
+        return broadcast(session, line, stateful);
+    }
+
+    const std::size_t index = find(target);
+    if (index >= backends.size())
+    {
+        session.fail(TCP_Status::UNKNOWN_COMMAND, command);
+        return std::string();
+    }
+    TCP_Client *client = connection(session, index, stateful);
+    const bool shared = client == backends[index].second.get();
+    std::vector<std::string> replies;
+    int handle = client == nullptr ? -1 : client->send({line});
+    if (handle < 0 || !client->receive(handle, 1, replies, shared))
+    {
+        session.fail(TCP_Status::UNAVAILABLE, backends[index].first);
+        return std::string();
+    }
+
+    // Re-render a backend error in this client's protocol and budget.
+    std::string token;
+    TCP_Status status = TCP_Reply::parseError(replies.front(), token);
+    if (status != TCP_Status::OK)
+    {
+        session.fail(status, token);
+        return std::string();
+    }
+    adoptProtocol(session, line);
+    return std::move(replies.front());
+}
+
+/**
+ * @brief Returns the client to reach a backend with for a session.
+ * @param session The client's session.
+ * @param index The backend's position in `backends`.
+ * @param pin Pin a connection to the session if it has none.
+ * @return The session's pinned client, the shared pool, or nullptr if too
+ *         many sessions have pinned connections.
+ */
+TCP_Client *TCP_ProxyHandler::connection(TCP_Session &session, std::size_t index, bool pin)
+{
+    TCP_Client *shared = backends[index].second.get();
+    if (session.id == 0)
+    {
+        return shared;
+    }
+    std::lock_guard<TCP_Mutex> lock(pinned_mutex);
+    auto entry = pinned.find(session.id);
+    if (entry != pinned.end() && entry->second[index])
+    {
+        return entry->second[index].get();
+    }
+    if (!pin)
+    {
+        return shared;
+    }
+    if (entry == pinned.end())
+    {
+        if (pinned.size() >= MAX_PINNED_SESSIONS)
+        {
+            return nullptr;
+        }
+        entry = pinned.emplace(session.id, std::vector<std::unique_ptr<TCP_Client>>(backends.size())).first;
+    }
+    entry->second[index] = std::make_unique<TCP_Client>(shared->host(), shared->port(), 1);
+    return entry->second[index].get();
+}
+
+/**
+ * @brief Sends one command to every backend and gathers the replies.
+ * @details All requests are written before any reply is read, so the
+ *          backends work in parallel and the total time is that of the
+ *          slowest backend rather than the sum. A backend's error is shown
+ *          in its place in the client's protocol; only if every backend
+ *          fails is the command reported as failed.
+ *
+ * @param session The client's session.
+ * @param line The command line to send.
+ * @param pin Pin connections to the session first (session commands).
+ * @return Replies joined as `name=reply; name=reply`.
+ */
+std::string TCP_ProxyHandler::broadcast(TCP_Session &session, const std::string &line, bool pin)
+{
+    const std::vector<std::string> commands = {line};
+    std::vector<TCP_Client *> clients;
+    std::vector<int> handles;
+    clients.reserve(backends.size());
+    handles.reserve(backends.size());
+    for (std::size_t i = 0; i < backends.size(); ++i)
+    {
+        clients.push_back(connection(session, i, pin));
+        handles.push_back(clients.back() == nullptr ? -1 : clients.back()->send(commands));
+    }
+
+    std::string reply;
+    std::vector<std::string> replies;
+    TCP_Status first_error = TCP_Status::OK;
+    std::string first_token;
+    bool answered = false;
+    for (size_t i = 0; i < backends.size(); ++i)
+    {
+        if (!reply.empty())
+        {
+            reply += "; ";
+        }
+        reply += backends[i].first + "=";
+        const bool shared = clients[i] == backends[i].second.get();
+        std::string token;
+        TCP_Status status = TCP_Status::UNAVAILABLE;
+        if (handles[i] >= 0 && clients[i]->receive(handles[i], 1, replies, shared))
+        {
+            status = TCP_Reply::parseError(replies.front(), token);
+        }
+        else
+        {
+            token = backends[i].first;
+        }
+        if (status == TCP_Status::OK)
+        {
+            reply += replies.front();
+            answered = true;
+            continue;
+        }
+        TCP_Reply::appendError(reply, session.terse(), status, token.data(), token.size(), false);
+        if (first_error == TCP_Status::OK)
+        {
+            first_error = status;
+            first_token = std::move(token);
+        }
+    }
+    if (!answered)
+    {
+        session.fail(first_error, first_token);
+        return std::string();
+    }
+    adoptProtocol(session, line);
+    return reply;
+}
+
+/**
+ * @brief Retrieves the routing prefixes.
+ * @return A set containing each `<backend>:` prefix and `*:`.
+ */
+const std::unordered_set<std::string> &TCP_ProxyHandler::getValidCommands() const
+{
+    return valid_commands;
+}
+
+/**
+ * @brief Finds a backend by name.
+ * @param name The backend name.
+ * @return Its position in `backends`, or `backends.size()` if unknown.
+ */
+std::size_t TCP_ProxyHandler::find(const std::string &name) const
+{
+    for (std::size_t i = 0; i < backends.size(); ++i)
+    {
+        if (backends[i].first == name)
+        {
+            return i;
+        }
+    }
+    return backends.size();
+}
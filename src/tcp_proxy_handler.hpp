@@ -0,0 +1,160 @@
+/**
+ * @file tcp_proxy_handler.hpp
+ * @brief Command handler that forwards commands to backend servers.
+ * @details This file defines TCP_ProxyHandler, which lets one TCP_Server
+ *          front several backend servers (for example one per transmitter).
+ *          Commands are routed by a `<backend>:` prefix:
+ *          - `tx1:freq 7040100` is sent to backend `tx1` as `freq 7040100`.
+ *          - `*:version` is sent to every backend in parallel and the
+ *            replies are gathered as `tx1=...; tx2=...`.
+ *          - `backends` lists the configured backends.
+ *          - Anything else is an unknown command and reaches no backend.
+ *
+ *          Each backend is reached through a TCP_Client, so connections are
+ *          persistent and pooled.
+ *
+ *          Errors, the proxy's own and the backends', are reported through
+ *          `TCP_Session::fail()`, so they are rendered in the client's
+ *          protocol and spend the client's error budget at the proxy.
+ *
+ *          Backend sessions belong to connections, so a pooled connection
+ *          must not carry one client's session state to another. A client
+ *          that sends a session command (`session`, `auth`, `subscribe`,
+ *          `unsubscribe`, `changes`) is pinned to a connection of its own
+ *          for the rest of its session, so its negotiated protocol and
+ *          subscriptions stay its own. A shared connection that returns an
+ *          error is closed rather than pooled, so one client's errors never
+ *          spend the error budget other clients' commands travel on.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_PROXY_HANDLER_HPP
+#define TCP_PROXY_HANDLER_HPP
+
+// Project includes
+#include "tcp_client.hpp"
+#include "tcp_command_interface.hpp"
+#include "tcp_mutex.hpp"
+
+// Standard includes
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @class TCP_ProxyHandler
+ * @brief Routes commands to backend servers by prefix.
+ */
+class TCP_ProxyHandler : public TCP_CommandHandler
+{
+public:
+    /// @brief Most sessions with pinned backend connections at a time.
+    static constexpr std::size_t MAX_PINNED_SESSIONS = 256;
+
+    /**
+     * @brief Adds a backend.
+     * @details Must be called before the server starts.
+     *
+     * @param name Routing prefix, without the colon.
+     * @param host Backend address (dotted IPv4).
+     * @param port Backend port.
+     * @param pool_size Maximum connections to this backend.
+     * @return False if the name is empty, reserved, or already used.
+     */
+    bool addBackend(const std::string &name, const std::string &host, int port, std::size_t pool_size = 4);
+
+    /**
+     * @brief Adds backends from a list like "tx1=127.0.0.1:31416,tx2=127.0.0.1:31417".
+     * @param spec Comma-separated `name=host:port` entries.
+     * @return False if any entry is malformed.
+     */
+    bool addBackends(const std::string &spec);
+
+    /**
+     * @brief Routes a command to its backend(s).
+     * @param command The command, prefixed with `<backend>:` or `*:`.
+     * @param arg The argument, forwarded unchanged.
+     * @return The backend reply, gathered replies, or an error.
+     */
+    std::string handleCommand(const std::string &command, const std::string &arg) override;
+
+    /**
+     * @brief Routes a command from a client connection.
+     * @param session State of the client connection; selects pinned
+     *                backend connections.
+     * @param command The command, prefixed with `<backend>:` or `*:`.
+     * @param arg The argument, forwarded unchanged.
+     * @return The backend reply or gathered replies; errors are reported
+     *         through `session.fail()`.
+     */
+    std::string handleCommand(TCP_Session &session, const std::string &command, const std::string &arg) override;
+
+    /**
+     * @brief Closes the backend connections pinned to a session.
+     * @param session State of the connection that closed.
+     */
+    void sessionClosed(TCP_Session &session) override;
+
+    /**
+     * @brief Retrieves the routing prefixes.
+     * @return A set containing each `<backend>:` prefix and `*:`.
+     */
+    const std::unordered_set<std::string> &getValidCommands() const override;
+
+private:
+    /// @brief Backends in configuration order.
+    std::vector<std::pair<std::string, std::unique_ptr<TCP_Client>>> backends;
+
+    /// @brief Routing prefixes reported by getValidCommands().
+    std::unordered_set<std::string> valid_commands;
+
+    /// @brief Connections pinned to a session, by session ID, one slot per backend.
+    std::unordered_map<uint64_t, std::vector<std::unique_ptr<TCP_Client>>> pinned;
+
+    /// @brief Guards `pinned`.
+    TCP_Mutex pinned_mutex{"proxy"};
+
+    /**
+     * @brief Routes a command to its backend(s).
+     * @param session The client's session; ID 0 uses the shared pools only.
+     * @param command The prefixed command.
+     * @param arg The argument.
+     * @return Response string; errors are reported through `session.fail()`.
+     */
+    std::string route(TCP_Session &session, const std::string &command, const std::string &arg);
+
+    /**
+     * @brief Returns the client to reach a backend with for a session.
+     * @param session The client's session.
+     * @param index The backend's position in `backends`.
+     * @param pin Pin a connection to the session if it has none.
+     * @return The session's pinned client, the shared pool, or nullptr if
+     *         MAX_PINNED_SESSIONS sessions already have pinned connections.
+     */
+    TCP_Client *connection(TCP_Session &session, std::size_t index, bool pin);
+
+    /**
+     * @brief Forwards a command to the backend named by its prefix.
+     * @param command The prefixed command.
+     * @param arg The argument.
+     * @return Response string.
+     */
+    std::string processCommand(const std::string &command, const std::string &arg) override;
+
+    /// @brief Sends one command to every backend and gathers the replies.
+    std::string broadcast(TCP_Session &session, const std::string &line, bool pin);
+
+    /// @brief Finds a backend by name.
+    /// @return Its position in `backends`, or `backends.size()` if unknown.
+    std::size_t find(const std::string &name) const;
+};
+
+#endif // TCP_PROXY_HANDLER_HPP
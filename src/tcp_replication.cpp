@@ -0,0 +1,486 @@
+/**
+ * @file tcp_replication.cpp
+ * @brief Implementation of primary-to-replica parameter streaming.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_replication.hpp"
+
+// Standard Includes
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+// System Includes
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/// @brief Most unsent bytes a replica may fall behind before it is dropped.
+constexpr const size_t REPLICA_BACKLOG_LIMIT = 1 << 20;
+
+/// @brief How often the sender retries replicas whose socket was full.
+constexpr const auto REPLICA_RETRY_INTERVAL = std::chrono::milliseconds(10);
+
+/// @brief How long the stream may be idle before the primary sends a heartbeat.
+constexpr const auto REPLICA_HEARTBEAT_INTERVAL = std::chrono::seconds(1);
+
+/// @brief How long a replica waits on a silent primary before reconnecting.
+constexpr const time_t REPLICA_TIMEOUT_SECONDS = 5;
+
+/**
+ * @brief Sends as much of a replica's backlog as its socket takes now.
+ * @param fd The replica's non-blocking socket.
+ * @param backlog Unsent bytes; what was sent is removed.
+ * @return False if the connection failed.
+ */
+static bool flush(int fd, std::string &backlog)
+{
+    size_t sent = 0;
+    while (sent < backlog.size())
+    {
+        ssize_t n = ::send(fd, backlog.data() + sent, backlog.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    backlog.erase(0, sent);
+    return true;
+}
+
+TCP_ReplicationPrimary::TCP_ReplicationPrimary()
+    : listen_fd_(-1),
+      store_(nullptr),
+      running_(false),
+      sequence_(0)
+{
+}
+
+TCP_ReplicationPrimary::~TCP_ReplicationPrimary()
+{
+    stop();
+}
+
+void TCP_ReplicationPrimary::callback(TCP_ServerPriority priority, const std::string &message, bool result)
+{
+    if (callback_)
+        callback_(priority, message, result);
+}
+
+/**
+ * @brief Starts listening for replicas.
+ * @param port Replication port.
+ * @param store Store whose contents are sent as the initial snapshot.
+ * @param address Address to bind.
+ * @param cb Optional event callback.
+ * @return True if the listener is running.
+ */
+bool TCP_ReplicationPrimary::start(int port, const TCP_ParamStore *store, const std::string &address,
+                                   TCP_ServerCallback cb)
+{
+    if (running_.load() || store == nullptr)
+    {
+        return false;
+    }
+    callback_ = std::move(cb);
+    store_ = store;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0)
+    {
+        callback(TCP_ServerPriority::ERROR, "Replication socket failed: " + std::string(strerror(errno)), false);
+        return false;
+    }
+    int opt = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1 ||
+        bind(listen_fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        listen(listen_fd_, 4) < 0)
+    {
+        callback(TCP_ServerPriority::ERROR, "Replication listen failed: " + std::string(strerror(errno)), false);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_.store(true);
+    accept_thread_ = std::thread(&TCP_ReplicationPrimary::accept_loop, this);
+    sender_thread_ = std::thread(&TCP_ReplicationPrimary::sender_loop, this);
+    callback(TCP_ServerPriority::INFO, "Replication primary listening on " + address + ":" + std::to_string(port), true);
+    return true;
+}
+
+/**
+ * @brief Stops listening and disconnects all replicas.
+ */
+void TCP_ReplicationPrimary::stop()
+{
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+    queue_cv_.notify_all();
+    if (accept_thread_.joinable())
+        accept_thread_.join();
+    if (sender_thread_.joinable())
+        sender_thread_.join();
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &replica : replicas_)
+    {
+        ::close(replica.fd);
+    }
+    replicas_.clear();
+    queue_.clear();
+}
+
+/**
+ * @brief Queues a change for every connected replica.
+ * @param key Parameter name.
+ * @param value New value.
+ */
+void TCP_ReplicationPrimary::publish(const std::string &key, const std::string &value)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++sequence_;
+        if (replicas_.empty())
+        {
+            // Nobody to send to; a future replica starts from a snapshot.
+            return;
+        }
+        queue_ += "P " + std::to_string(sequence_) + " " + key + " " + value + "\n";
+    }
+    queue_cv_.notify_one();
+}
+
+/**
+ * @brief Returns the sequence number of the latest change.
+ */
+uint64_t TCP_ReplicationPrimary::sequence() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sequence_;
+}
+
+/**
+ * @brief Accepts replicas and queues a snapshot for each one.
+ * @details The snapshot is built and queued under the queue lock, so it
+ *          covers exactly the changes up to its sequence number and the
+ *          replica joins the stream right after it. The sender thread
+ *          sends it, so a slow replica never holds up this loop.
+ */
+void TCP_ReplicationPrimary::accept_loop()
+{
+    while (running_.load())
+    {
+        struct pollfd pfd = {listen_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0)
+        {
+            continue;
+        }
+        int opt = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Replica replica;
+            replica.fd = fd;
+            replica.backlog = "S " + std::to_string(sequence_) + "\n";
+            for (const auto &entry : store_->snapshot())
+            {
+                replica.backlog += "V " + entry.first + " " + entry.second + "\n";
+            }
+            replica.backlog += "E\n";
+            replicas_.push_back(std::move(replica));
+            callback(TCP_ServerPriority::INFO, "Replica connected at sequence " + std::to_string(sequence_), true);
+        }
+        queue_cv_.notify_one();
+    }
+}
+
+/**
+ * @brief Sends queued changes in batches.
+ * @details Everything queued while the previous batch was being sent goes
+ *          out together in one write per replica. Sends never block: what
+ *          a replica's socket does not take stays in its backlog and is
+ *          retried every REPLICA_RETRY_INTERVAL, so one stalled replica
+ *          does not hold up the others. A replica whose backlog passes
+ *          REPLICA_BACKLOG_LIMIT is dropped; it reconnects and resyncs
+ *          from a snapshot. After REPLICA_HEARTBEAT_INTERVAL without a
+ *          change, a heartbeat is sent so replicas can detect a dead
+ *          primary.
+ */
+void TCP_ReplicationPrimary::sender_loop()
+{
+    bool backlogged = false;
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto ready = [this]
+        { return !queue_.empty() || !running_.load(); };
+        if (backlogged)
+        {
+            queue_cv_.wait_for(lock, REPLICA_RETRY_INTERVAL, ready);
+        }
+        else if (!queue_cv_.wait_for(lock, REPLICA_HEARTBEAT_INTERVAL, ready) && !replicas_.empty())
+        {
+            queue_ = "H\n";
+        }
+        if (!running_.load())
+            break;
+
+        size_t dropped = 0;
+        backlogged = false;
+        for (auto it = replicas_.begin(); it != replicas_.end();)
+        {
+            it->backlog += queue_;
+            if (!flush(it->fd, it->backlog) || it->backlog.size() > REPLICA_BACKLOG_LIMIT)
+            {
+                ::close(it->fd);
+                it = replicas_.erase(it);
+                ++dropped;
+                continue;
+            }
+            backlogged = backlogged || !it->backlog.empty();
+            ++it;
+        }
+        queue_.clear();
+        if (dropped > 0)
+        {
+            callback(TCP_ServerPriority::WARN, "Dropped " + std::to_string(dropped) + " replica(s); they resync from a snapshot.", false);
+        }
+    }
+}
+
+TCP_ReplicationReplica::TCP_ReplicationReplica()
+    : port_(0),
+      store_(nullptr),
+      running_(false),
+      synced_(false),
+      sequence_(0),
+      socket_fd_(-1)
+{
+}
+
+TCP_ReplicationReplica::~TCP_ReplicationReplica()
+{
+    stop();
+}
+
+void TCP_ReplicationReplica::callback(TCP_ServerPriority priority, const std::string &message, bool result)
+{
+    if (callback_)
+        callback_(priority, message, result);
+}
+
+/**
+ * @brief Starts following a primary.
+ * @param host Primary address (dotted IPv4).
+ * @param port Primary replication port.
+ * @param store Store to apply changes to.
+ * @param cb Optional event callback.
+ * @return True if the follower thread started.
+ */
+bool TCP_ReplicationReplica::start(const std::string &host, int port, TCP_ParamStore *store, TCP_ServerCallback cb)
+{
+    if (running_.load() || store == nullptr)
+    {
+        return false;
+    }
+    host_ = host;
+    port_ = port;
+    store_ = store;
+    callback_ = std::move(cb);
+    running_.store(true);
+    thread_ = std::thread(&TCP_ReplicationReplica::follow_loop, this);
+    return true;
+}
+
+/**
+ * @brief Stops following the primary.
+ */
+void TCP_ReplicationReplica::stop()
+{
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+    int fd = socket_fd_.load();
+    if (fd != -1)
+    {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+/**
+ * @brief Connects, applies the stream, and reconnects until stopped.
+ */
+void TCP_ReplicationReplica::follow_loop()
+{
+    bool first_attempt = true;
+    while (running_.load())
+    {
+        if (!first_attempt)
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            if (!running_.load())
+                break;
+        }
+        first_attempt = false;
+        synced_.store(false);
+
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0)
+        {
+            // Bounds the connect as well as every read, so an unreachable
+            // or dead primary is noticed instead of blocking forever.
+            struct timeval timeout = {REPLICA_TIMEOUT_SECONDS, 0};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        }
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port_);
+        if (fd < 0 || inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) != 1 ||
+            ::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+        {
+            if (fd >= 0)
+                ::close(fd);
+            continue;
+        }
+        socket_fd_.store(fd);
+        callback(TCP_ServerPriority::INFO, "Connected to primary " + host_ + ":" + std::to_string(port_), true);
+
+        std::string pending;
+        char buffer[4096];
+        bool in_sync = true;
+        bool timed_out = false;
+        while (running_.load() && in_sync)
+        {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                timed_out = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+                break;
+            }
+            pending.append(buffer, static_cast<size_t>(n));
+            size_t start = 0;
+            size_t end;
+            while (in_sync && (end = pending.find('\n', start)) != std::string::npos)
+            {
+                in_sync = apply(pending.substr(start, end - start));
+                start = end + 1;
+            }
+            pending.erase(0, start);
+        }
+
+        socket_fd_.store(-1);
+        ::close(fd);
+        if (running_.load())
+        {
+            callback(TCP_ServerPriority::WARN,
+                     !in_sync    ? "Sequence gap, resyncing."
+                     : timed_out ? "Primary silent, reconnecting."
+                                 : "Lost primary, reconnecting.",
+                     false);
+        }
+    }
+    synced_.store(false);
+}
+
+/**
+ * @brief Applies one protocol line.
+ * @param line A line without its terminator.
+ * @return False if the stream is out of sequence and must be resynced.
+ */
+bool TCP_ReplicationReplica::apply(const std::string &line)
+{
+    if (line.size() < 1)
+    {
+        return true;
+    }
+    const char type = line[0];
+    if (type == 'S')
+    {
+        synced_.store(false);
+        sequence_.store(std::strtoull(line.c_str() + 1, nullptr, 10));
+        return true;
+    }
+    if (type == 'H')
+    {
+        return true;
+    }
+    if (type == 'E')
+    {
+        synced_.store(true);
+        callback(TCP_ServerPriority::INFO, "Replica synced at sequence " + std::to_string(sequence_.load()), true);
+        return true;
+    }
+
+    // "V <name> <value>" or "P <seq> <name> <value>"
+    size_t pos = 2;
+    if (type == 'P')
+    {
+        char *after = nullptr;
+        uint64_t seq = std::strtoull(line.c_str() + pos, &after, 10);
+        if (seq <= sequence_.load())
+        {
+            return true; // Already covered by the snapshot.
+        }
+        if (seq != sequence_.load() + 1)
+        {
+            return false;
+        }
+        sequence_.store(seq);
+        pos = static_cast<size_t>(after - line.c_str()) + 1;
+    }
+    else if (type != 'V')
+    {
+        return true;
+    }
+    if (pos >= line.size())
+    {
+        return true;
+    }
+    size_t space = line.find(' ', pos);
+    std::string key = line.substr(pos, space == std::string::npos ? std::string::npos : space - pos);
+    std::string value = space == std::string::npos ? std::string() : line.substr(space + 1);
+    store_->set(key, value);
+    return true;
+}
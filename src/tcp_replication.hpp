@@ -0,0 +1,203 @@
+/**
+ * @file tcp_replication.hpp
+ * @brief Primary-to-replica streaming of parameter changes.
+ * @details This file defines the two ends of a replication channel for
+ *          TCP_ParamStore contents:
+ *          - TCP_ReplicationPrimary accepts replica connections, sends each
+ *            one a snapshot, then streams every parameter set in batches.
+ *            Replicas that fall too far behind are dropped and resync.
+ *          - TCP_ReplicationReplica connects to a primary and applies the
+ *            snapshot and the stream to a local store, so a hot standby
+ *            holds identical state and can take over immediately.
+ *
+ *          The channel is newline-framed text:
+ *          - `S <seq>` starts a snapshot that includes all changes up to `seq`.
+ *          - `V <name> <value>` is a snapshot entry.
+ *          - `E` ends the snapshot.
+ *          - `P <seq> <name> <value>` is a change; `seq` increases by one
+ *            per change. A replica that sees a gap reconnects and resyncs.
+ *          - `H` is a heartbeat, sent when the stream has been idle, so a
+ *            replica can tell a quiet primary from a dead one.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_REPLICATION_HPP
+#define TCP_REPLICATION_HPP
+
+// Project includes
+#include "tcp_param_store.hpp"
+#include "tcp_server_policies.hpp"
+
+// Standard includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class TCP_ReplicationPrimary
+ * @brief Streams parameter changes to connected replicas.
+ */
+class TCP_ReplicationPrimary
+{
+public:
+    TCP_ReplicationPrimary();
+    ~TCP_ReplicationPrimary();
+
+    // Disable copying.
+    TCP_ReplicationPrimary(const TCP_ReplicationPrimary &) = delete;
+    TCP_ReplicationPrimary &operator=(const TCP_ReplicationPrimary &) = delete;
+
+    /**
+     * @brief Starts listening for replicas.
+     *
+     * @param port Replication port.
+     * @param store Store whose contents are sent as the initial snapshot.
+     * @param address Address to bind; use "0.0.0.0" for replicas on a LAN.
+     * @param cb Optional event callback, as for TCP_Server::start().
+     * @return True if the listener is running.
+     */
+    bool start(int port, const TCP_ParamStore *store, const std::string &address = "127.0.0.1",
+               TCP_ServerCallback cb = nullptr);
+
+    /**
+     * @brief Stops listening and disconnects all replicas.
+     */
+    void stop();
+
+    /**
+     * @brief Queues a change for every connected replica.
+     * @details Suitable as a TCP_Commands change listener.
+     *
+     * @param key Parameter name.
+     * @param value New value.
+     */
+    void publish(const std::string &key, const std::string &value);
+
+    /**
+     * @brief Returns the sequence number of the latest change.
+     */
+    uint64_t sequence() const;
+
+private:
+    /// @brief Replication listening socket.
+    int listen_fd_;
+
+    /// @brief Source of snapshots for new replicas.
+    const TCP_ParamStore *store_;
+
+    /// @brief Indicates if the primary is running.
+    std::atomic<bool> running_;
+
+    /// @brief Accepts replicas and sends their snapshot.
+    std::thread accept_thread_;
+
+    /// @brief Sends queued changes in batches.
+    std::thread sender_thread_;
+
+    /// @brief Guards the queue, the replica list, and the sequence.
+    mutable std::mutex mutex_;
+    std::condition_variable queue_cv_;
+
+    /// @brief Encoded changes waiting to be sent.
+    std::string queue_;
+
+    /// @brief A connected replica.
+    struct Replica
+    {
+        int fd;              ///< Non-blocking socket.
+        std::string backlog; ///< Bytes its socket has not taken yet.
+    };
+
+    /// @brief Connected replicas.
+    std::vector<Replica> replicas_;
+
+    /// @brief Sequence number of the latest queued change.
+    uint64_t sequence_;
+
+    /// @brief Optional event callback.
+    TCP_ServerCallback callback_;
+
+    void callback(TCP_ServerPriority priority, const std::string &message, bool result);
+    void accept_loop();
+    void sender_loop();
+};
+
+/**
+ * @class TCP_ReplicationReplica
+ * @brief Follows a primary and mirrors its parameters into a local store.
+ */
+class TCP_ReplicationReplica
+{
+public:
+    TCP_ReplicationReplica();
+    ~TCP_ReplicationReplica();
+
+    // Disable copying.
+    TCP_ReplicationReplica(const TCP_ReplicationReplica &) = delete;
+    TCP_ReplicationReplica &operator=(const TCP_ReplicationReplica &) = delete;
+
+    /**
+     * @brief Starts following a primary.
+     * @details Reconnects with a one second back-off whenever the
+     *          connection drops, a sequence gap is detected, or the
+     *          primary sends nothing, not even a heartbeat, for five
+     *          seconds.
+     *
+     * @param host Primary address (dotted IPv4).
+     * @param port Primary replication port.
+     * @param store Store to apply changes to.
+     * @param cb Optional event callback, as for TCP_Server::start().
+     * @return True if the follower thread started.
+     */
+    bool start(const std::string &host, int port, TCP_ParamStore *store, TCP_ServerCallback cb = nullptr);
+
+    /**
+     * @brief Stops following the primary.
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether the replica is following a primary.
+     */
+    bool isRunning() const { return running_.load(); }
+
+    /**
+     * @brief Returns the sequence number of the last applied change.
+     */
+    uint64_t sequence() const { return sequence_.load(); }
+
+    /**
+     * @brief Checks whether the replica holds a complete snapshot.
+     */
+    bool isSynced() const { return synced_.load(); }
+
+private:
+    std::string host_;
+    int port_;
+    TCP_ParamStore *store_;
+    std::atomic<bool> running_;
+    std::atomic<bool> synced_;
+    std::atomic<uint64_t> sequence_;
+    std::atomic<int> socket_fd_;
+    std::thread thread_;
+    TCP_ServerCallback callback_;
+
+    void callback(TCP_ServerPriority priority, const std::string &message, bool result);
+    void follow_loop();
+
+    /**
+     * @brief Applies one protocol line.
+     * @return False if the stream is out of sequence and must be resynced.
+     */
+    bool apply(const std::string &line);
+};
+
+#endif // TCP_REPLICATION_HPP
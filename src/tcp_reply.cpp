@@ -0,0 +1,181 @@
+/**
+ * @file tcp_reply.cpp
+ * @brief Implementation of the terse reply helpers.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_reply.hpp"
+
+/**
+ * @brief Fixed text around the token of an error message.
+ */
+struct ErrorText
+{
+    const char *prefix;
+    const char *suffix;
+};
+
+/**
+ * @brief Returns the interned text for an error status.
+ */
+static ErrorText errorText(TCP_Status status)
+{
+    switch (status)
+    {
+    case TCP_Status::UNKNOWN_COMMAND:
+        return {"ERROR: Unknown command '", "'. Type 'help' for a list of commands."};
+    case TCP_Status::INVALID_ARGUMENT:
+        return {"ERROR: Invalid argument '", "'."};
+    case TCP_Status::LINE_TOO_LONG:
+        return {"ERROR: Command too long.", nullptr};
+    case TCP_Status::NOT_PERMITTED:
+        return {"ERROR: Not permitted: '", "'. Authenticate with 'auth <token>'."};
+    case TCP_Status::STORE_FAILED:
+        return {"ERROR: Unable to store ", "."};
+    case TCP_Status::UNAVAILABLE:
+        return {"ERROR: Backend unavailable: '", "'."};
+    default:
+        return {"ERROR: Request failed.", nullptr};
+    }
+}
+
+/**
+ * @brief Returns the preformatted reply for a bare status.
+ * @param status The status.
+ * @return A reference to a string that lives for the whole program.
+ */
+const std::string &TCP_Reply::status(TCP_Status status)
+{
+    static const std::string ok = "0";
+    static const std::string no_value = "1";
+    static const std::string unknown_command = "10";
+    static const std::string invalid_argument = "11";
+    static const std::string line_too_long = "12";
+    static const std::string not_permitted = "13";
+    static const std::string store_failed = "20";
+    static const std::string request_failed = "21";
+    static const std::string unavailable = "22";
+
+    switch (status)
+    {
+    case TCP_Status::OK:
+        return ok;
+    case TCP_Status::NO_VALUE:
+        return no_value;
+    case TCP_Status::UNKNOWN_COMMAND:
+        return unknown_command;
+    case TCP_Status::INVALID_ARGUMENT:
+        return invalid_argument;
+    case TCP_Status::LINE_TOO_LONG:
+        return line_too_long;
+    case TCP_Status::NOT_PERMITTED:
+        return not_permitted;
+    case TCP_Status::REQUEST_FAILED:
+        return request_failed;
+    case TCP_Status::UNAVAILABLE:
+        return unavailable;
+    case TCP_Status::STORE_FAILED:
+    default:
+        return store_failed;
+    }
+}
+
+/**
+ * @brief Returns a success reply carrying a value.
+ * @param value The value.
+ * @return "0 <value>".
+ */
+std::string TCP_Reply::value(const std::string &value)
+{
+    std::string reply;
+    reply.reserve(value.size() + 2);
+    reply += "0 ";
+    reply += value;
+    return reply;
+}
+
+/**
+ * @brief Appends an error reply (without terminator) to `output`.
+ * @param output The connection's output buffer.
+ * @param terse True for the terse protocol.
+ * @param status The error status.
+ * @param token The offending token, or nullptr.
+ * @param length Bytes of `token` to copy.
+ * @param truncated True if `token` was cut short.
+ */
+void TCP_Reply::appendError(std::string &output, bool terse, TCP_Status status,
+                            const char *token, std::size_t length, bool truncated)
+{
+    if (terse)
+    {
+        output += TCP_Reply::status(status);
+        return;
+    }
+    ErrorText text = errorText(status);
+    output += text.prefix;
+    if (text.suffix != nullptr)
+    {
+        if (token != nullptr)
+        {
+            output.append(token, length);
+        }
+        if (truncated)
+        {
+            output += "...";
+        }
+        output += text.suffix;
+    }
+}
+
+/// @brief Every error status, for parseError().
+static const TCP_Status ERROR_STATUSES[] = {
+    TCP_Status::UNKNOWN_COMMAND, TCP_Status::INVALID_ARGUMENT, TCP_Status::LINE_TOO_LONG, TCP_Status::NOT_PERMITTED,
+    TCP_Status::STORE_FAILED, TCP_Status::REQUEST_FAILED, TCP_Status::UNAVAILABLE};
+
+/**
+ * @brief Recovers the status of an error reply.
+ * @param reply A reply in either protocol.
+ * @param token Receives the quoted token, if any.
+ * @return The error status, or TCP_Status::OK if `reply` is not an error.
+ */
+TCP_Status TCP_Reply::parseError(const std::string &reply, std::string &token)
+{
+    token.clear();
+    for (TCP_Status status : ERROR_STATUSES)
+    {
+        // A terse error is its code alone; text replies are never a bare number.
+        if (reply == TCP_Reply::status(status))
+        {
+            return status;
+        }
+    }
+    if (reply.compare(0, 6, "ERROR:") != 0)
+    {
+        return TCP_Status::OK;
+    }
+    for (TCP_Status status : ERROR_STATUSES)
+    {
+        ErrorText text = errorText(status);
+        const std::string prefix = text.prefix;
+        if (reply.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        if (text.suffix == nullptr)
+        {
+            return status;
+        }
+        const std::string suffix = text.suffix;
+        if (reply.size() >= prefix.size() + suffix.size() &&
+            reply.compare(reply.size() - suffix.size(), suffix.size(), suffix) == 0)
+        {
+            token = reply.substr(prefix.size(), reply.size() - prefix.size() - suffix.size());
+            return status;
+        }
+    }
+    return TCP_Status::REQUEST_FAILED;
+}
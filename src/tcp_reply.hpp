@@ -0,0 +1,98 @@
+/**
+ * @file tcp_reply.hpp
+ * @brief Status codes and preformatted replies for the terse protocol.
+ * @details This file defines TCP_Status and TCP_Reply. A session that
+ *          negotiates `TCP_Protocol::TERSE` receives replies of the form
+ *          `<code>` or `0 <value>` instead of sentences. Replies without a
+ *          value are rendered once and returned by reference, so the common
+ *          outcomes cost no formatting at all.
+ *
+ *          Error replies are interned the same way in both protocols: the
+ *          fixed parts of each message exist once, and only a bounded copy
+ *          of the offending token is appended straight into the output
+ *          buffer. Handlers report errors through `TCP_Session::fail()`.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_REPLY_HPP
+#define TCP_REPLY_HPP
+
+// Standard includes
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Numeric reply status codes.
+ * @details Values below 10 are successes, 10-19 are client errors, and 20
+ *          and above are server errors.
+ */
+enum class TCP_Status
+{
+    OK = 0,                ///< Done; followed by the value for queries.
+    NO_VALUE = 1,          ///< Done, but there is no value to report.
+    UNKNOWN_COMMAND = 10,  ///< The command is not recognized.
+    INVALID_ARGUMENT = 11, ///< The argument is not valid for the command.
+    LINE_TOO_LONG = 12,    ///< The command line exceeded the length limit.
+    NOT_PERMITTED = 13,    ///< The command needs an authenticated client.
+    STORE_FAILED = 20,     ///< The value could not be stored.
+    REQUEST_FAILED = 21,   ///< Failed for a reason with no code of its own.
+    UNAVAILABLE = 22       ///< A backend behind a proxy could not be reached.
+};
+
+/**
+ * @class TCP_Reply
+ * @brief Builds terse replies.
+ */
+class TCP_Reply
+{
+public:
+    /**
+     * @brief Returns the preformatted reply for a bare status, e.g. "10".
+     * @param status The status.
+     * @return A reference to a string that lives for the whole program.
+     */
+    static const std::string &status(TCP_Status status);
+
+    /**
+     * @brief Returns a success reply carrying a value: "0 <value>".
+     * @param value The value.
+     * @return The reply.
+     */
+    static std::string value(const std::string &value);
+
+    /**
+     * @brief Appends an error reply (without terminator) to `output`.
+     * @details Text replies are the interned message around the token,
+     *          e.g. "ERROR: Unknown command 'x'. Type 'help' ...", with the
+     *          token cut at `length` and marked "..." if `truncated`.
+     *          Terse replies are the status code alone.
+     *
+     * @param output The connection's output buffer.
+     * @param terse True for the terse protocol.
+     * @param status The error status.
+     * @param token The offending token, or nullptr.
+     * @param length Bytes of `token` to copy.
+     * @param truncated True if `token` was cut short.
+     */
+    static void appendError(std::string &output, bool terse, TCP_Status status,
+                            const char *token, std::size_t length, bool truncated);
+
+    /**
+     * @brief Recovers the status of an error reply.
+     * @details The inverse of appendError(), so a proxy can re-render a
+     *          backend's error in its client's protocol. Accepts both
+     *          protocols; a text error with no interned text (e.g. from a
+     *          plugin) is REQUEST_FAILED.
+     *
+     * @param reply A reply in either protocol.
+     * @param token Receives the quoted token, if any.
+     * @return The error status, or TCP_Status::OK if `reply` is not an error.
+     */
+    static TCP_Status parseError(const std::string &reply, std::string &token);
+};
+
+#endif // TCP_REPLY_HPP
@@ -1,10 +1,17 @@
 /**
  * @file tcp_server.hpp
- * @brief Header file for the TCP_Server class.
+ * @brief Header file for the BasicTCPServer template and TCP_Server alias.
  * @details This file defines the interface for a multi-threaded TCP server
  *          that listens for incoming client connections, processes commands,
  *          and delegates command handling to a user-defined handler class.
  *
+ *          The server is a template over four compile-time policies (see
+ *          tcp_server_policies.hpp) and the concrete handler type. When the
+ *          handler type is a `final` class the compiler binds
+ *          `handleCommand()` statically, and with `TCP_NullLog` every log
+ *          message is removed from the build. `TCP_Server` keeps the
+ *          historical behavior.
+ *
  * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
  * @license MIT License (see LICENSE file for details)
  *
@@ -20,48 +27,89 @@
 #define TCP_SERVER_HPP
 
 // Project includes
+#include "tcp_alloc_tracker.hpp"
+#include "tcp_command_costs.hpp"
 #include "tcp_command_handler.hpp" // Use an external command handler
+#include "tcp_flight_recorder.hpp"
+#include "tcp_mutex.hpp"
+#include "tcp_reply.hpp"
+#include "tcp_server_policies.hpp"
+#include "tcp_session.hpp"
+#include "tcp_socket_profile.hpp"
+#include "tcp_stats.hpp"
 
 // Standard includes
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <unordered_set>
 
 /**
- * @class TCP_Server
+ * @struct TCP_ServerStats
+ * @brief Point-in-time snapshot of server activity counters.
+ */
+struct TCP_ServerStats
+{
+    uint64_t connections = 0; ///< Client connections accepted since start.
+    uint64_t commands = 0;    ///< Commands dispatched to the handler.
+    int active = 0;           ///< Client connections currently open.
+};
+
+/**
+ * @brief Counters a server keeps in its TCP_Stats.
+ */
+enum TCP_ServerCounter : std::size_t
+{
+    STAT_CONNECTIONS, ///< Client connections accepted.
+    STAT_COMMANDS,    ///< Commands dispatched to the handler.
+    STAT_ACTIVE       ///< Client connections currently open.
+};
+
+/**
+ * @brief Histograms a server keeps in its TCP_Stats.
+ */
+enum TCP_ServerHistogram : std::size_t
+{
+    STAT_COMMAND_NS ///< Wall time spent in the handler per command, ns.
+};
+
+/**
+ * @class BasicTCPServer
  * @brief A multi-threaded TCP server that processes user-defined commands.
- * @details This server listens for incoming TCP connections, spawns worker
- *          threads to handle clients, and forwards commands to a command handler.
- *          It ensures thread-safe operation and graceful shutdown.
+ * @details This server listens for incoming TCP connections, hands clients
+ *          to the threading policy, and forwards commands to a command
+ *          handler. It ensures thread-safe operation and graceful shutdown.
+ *
+ * @tparam IoPolicy How the accept loop waits for connections.
+ * @tparam ThreadingPolicy Which thread serves a client connection.
+ * @tparam LogPolicy Where server event messages go.
+ * @tparam Handler The command handler type, either the abstract
+ *                 `TCP_CommandHandler` or a concrete (ideally `final`) class.
  */
-class TCP_Server
+template <typename IoPolicy, typename ThreadingPolicy, typename LogPolicy, typename Handler>
+class BasicTCPServer
 {
 public:
-    // Public enum for callback priorities. Matches those in LCBLog.
-    enum class Priority
-    {
-        DEBUG = 0, ///< Debug-level messages for detailed troubleshooting.
-        INFO,      ///< Informational messages for general system state.
-        WARN,      ///< Warnings indicating potential issues.
-        ERROR,     ///< Errors that require attention but allow continued execution.
-        FATAL      ///< Critical errors that result in program termination.
-    };
+    /// @brief Callback priorities. Matches those in LCBLog.
+    using Priority = TCP_ServerPriority;
 
     /**
      * @brief Constructs a TCP server instance.
      */
-    TCP_Server();
+    BasicTCPServer();
 
     /**
      * @brief Destructor for the TCP server.
      * @details Ensures proper shutdown and resource cleanup.
      */
-    ~TCP_Server();
+    ~BasicTCPServer();
 
     // Disable copying.
-    TCP_Server(const TCP_Server &) = delete;
-    TCP_Server &operator=(const TCP_Server &) = delete;
+    BasicTCPServer(const BasicTCPServer &) = delete;
+    BasicTCPServer &operator=(const BasicTCPServer &) = delete;
 
     /**
      * @brief Starts the TCP server.
@@ -71,14 +119,17 @@ public:
      * @param handler Pointer to a user-defined command handler.
      * @param callback Optional callback that will be invoked with a message string and a success flag.
      *                 For example: [](Priority::INFO, const std::string &msg, bool success){ ... }
+     *                 Ignored when the log policy is disabled.
+     * @param profile Socket options for the listener and accepted sockets.
      * @return True if the server starts successfully, false otherwise.
      */
-    bool start(int port, TCP_CommandHandler *handler,
-        std::function<void(TCP_Server::Priority, const std::string &, bool)> cb = nullptr);
+    bool start(int port, Handler *handler, TCP_ServerCallback cb = nullptr,
+               TCP_SocketProfile profile = TCP_SocketProfile::DEFAULT);
 
     /**
      * @brief Stops the TCP server.
-     * @details Closes the listening socket and gracefully exits the main server loop.
+     * @details Closes the listening socket, exits the main server loop,
+     *          and waits for every client connection's thread to finish.
      */
     void stop();
 
@@ -97,9 +148,50 @@ public:
      */
     bool isRunning() const { return running_.load(); }
 
+    /**
+     * @brief Returns a snapshot of the activity counters.
+     * @return Connections accepted, commands handled, and open connections.
+     */
+    TCP_ServerStats getStats() const;
+
+    /**
+     * @brief Provides the sharded counters and histograms behind getStats().
+     * @return Stats indexed by TCP_ServerCounter and TCP_ServerHistogram.
+     */
+    const TCP_Stats &stats() const { return stats_; }
+
+    /**
+     * @brief Provides access to the threading policy for configuration.
+     * @details Must only be used while the server is stopped.
+     */
+    ThreadingPolicy &threadingPolicy() { return threading_; }
+
+    /**
+     * @brief Provides access to the I/O policy for configuration and stats.
+     * @details Configuration must only change while the server is stopped.
+     */
+    IoPolicy &ioPolicy() { return io_; }
+
+    /**
+     * @brief Records every command in a flight recorder.
+     * @details Must only be set while the server is stopped.
+     *
+     * @param recorder The recorder, or nullptr to stop recording.
+     */
+    void setFlightRecorder(TCP_FlightRecorder *recorder) { recorder_ = recorder; }
+
+    /**
+     * @brief Accounts the handler's CPU and wall time per command.
+     * @details Unknown commands are counted together as "(unknown)". Must
+     *          only be set while the server is stopped.
+     *
+     * @param costs The accounting, or nullptr to stop measuring.
+     */
+    void setCommandCosts(TCP_CommandCosts *costs) { costs_ = costs; }
+
 private:
     /// @brief Mutex for synchronizing server start/stop operations.
-    std::mutex server_mutex_;
+    TCP_Mutex server_mutex_;
 
     /// @brief Main server thread responsible for listening for connections.
     std::thread server_thread_;
@@ -111,18 +203,42 @@ private:
     std::atomic<bool> running_;
 
     /// @brief Pointer to the command handler instance.
-    TCP_CommandHandler *command_handler_;
+    Handler *command_handler_;
 
     /// @brief The file descriptor for the server socket.
     int server_fd_;
 
-    /// @brief Tracks the number of active connections.
-    static std::atomic<int> active_connections_;
+    /// @brief Sockets of connected clients, shut down by stop().
+    std::unordered_set<int> client_sockets_;
+
+    /// @brief Guards client_sockets_.
+    TCP_Mutex clients_mutex_;
+
+    /// @brief Last session ID handed out; used only by the accept thread.
+    uint64_t last_session_id_;
+
+    /// @brief Activity counters, sharded per thread (see TCP_ServerCounter).
+    TCP_Stats stats_;
+
+    /// @brief Optional record of recent commands, for crash analysis.
+    TCP_FlightRecorder *recorder_;
 
-    // Store the callback so you can call it later from any method.
-    std::function<void(Priority, const std::string &, bool)> callback_;
+    /// @brief Optional per-command CPU accounting.
+    TCP_CommandCosts *costs_;
 
-    void callback(Priority priority, std::string message, bool result);
+    /// @brief Socket options selected at start().
+    TCP_SocketTuning tuning_;
+
+    /// @brief Accept loop wait strategy.
+    IoPolicy io_;
+
+    /// @brief Client connection threading strategy.
+    ThreadingPolicy threading_;
+
+    /// @brief Server event sink; stores the callback passed to start().
+    LogPolicy log_;
+
+    void callback(Priority priority, const std::string &message, bool result);
 
     /**
      * @brief Runs the main server loop.
@@ -131,13 +247,71 @@ private:
      */
     void run_server();
 
+    /**
+     * @brief Answers a deferred-accept connection on the accept thread.
+     * @param client_socket The accepted socket.
+     * @param session The new connection's session.
+     * @param pending Receives the input left for handle_client().
+     * @return True if the connection was finished and closed.
+     */
+    bool serve_inline(int client_socket, TCP_Session &session, std::string &pending);
+
     /**
      * @brief Handles a client connection.
      * @param client_socket The socket descriptor for the client connection.
-     * @details Reads input from the client, processes commands via the command handler,
-     *          sends responses, and closes the connection.
+     * @param session The connection's session, kept until it closes.
+     * @param pending Input already received but not yet processed.
+     * @details Reads newline-terminated commands from the client, processes
+     *          them via the command handler, and sends the responses until
+     *          the client disconnects.
+     */
+    void handle_client(int client_socket, TCP_Session session, std::string pending);
+
+    /**
+     * @brief Processes every complete line in `pending` and removes it.
+     * @param session The connection's session.
+     * @param pending Received input; keeps any unterminated remainder.
+     * @param output Receives the responses.
+     * @param quick_only Stop at the first line whose command is not quick.
+     * @return False if the client exhausted its error budget.
+     */
+    bool process_lines(TCP_Session &session, std::string &pending, std::string &output, bool quick_only = false);
+
+    /**
+     * @brief Tells whether the command of a line is quick (see
+     *        TCP_CommandHandler::isQuick()).
+     * @param line A command line, with or without its terminator.
+     * @return True if the line may be answered on the accept thread.
+     */
+    bool is_quick(const std::string &line) const;
+
+    /**
+     * @brief Parses and dispatches one command line.
+     * @param session The connection's session.
+     * @param input The command line without its terminator.
+     * @param output Receives the response followed by a newline.
+     * @return False if the client exhausted its error budget.
      */
-    void handle_client(int client_socket);
+    bool process_line(TCP_Session &session, std::string input, std::string &output);
+
+    /**
+     * @brief Sends an entire buffer to a client.
+     * @return True if every byte was sent.
+     */
+    static bool send_all(int client_socket, const std::string &data);
 };
 
-#endif // TCP_SERVER_HPP
\ No newline at end of file
+/**
+ * @brief The historical server: polling accept, a thread per connection,
+ *        callback logging, and a virtual command handler.
+ */
+using TCP_Server = BasicTCPServer<TCP_PollingAccept, TCP_ThreadPerConnection,
+                                  TCP_CallbackLog, TCP_CommandHandler>;
+
+// TCP_Server is compiled once in tcp_server.cpp.
+extern template class BasicTCPServer<TCP_PollingAccept, TCP_ThreadPerConnection,
+                                     TCP_CallbackLog, TCP_CommandHandler>;
+
+#include "tcp_server.tpp"
+
+#endif // TCP_SERVER_HPP
@@ -0,0 +1,787 @@
+/**
+ * @file tcp_server.tpp
+ * @brief Implementation of the BasicTCPServer template.
+ * @details This file contains the implementation of a multi-threaded TCP server
+ *          that listens for incoming client connections, processes commands,
+ *          and ensures thread-safe execution. It is included by
+ *          tcp_server.hpp and must not be included directly.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @note This server is designed to accept connections only from `127.0.0.1`
+ *       for security reasons.
+ * @note Implements rate limiting to prevent abuse.
+ * @note Ensures graceful shutdown by notifying active clients.
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_SERVER_TPP
+#define TCP_SERVER_TPP
+
+// Standard Includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+// System Includes
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/// @brief Defines the maximum number of simultaneous connections allowed.
+constexpr const int MAX_CONNECTIONS = 15;
+
+/// @brief Longest command line accepted before the client is disconnected.
+constexpr const size_t MAX_LINE_LENGTH = 1024;
+
+/// @brief Consecutive error replies after which a client is disconnected.
+constexpr const unsigned ERROR_BUDGET = 16;
+
+/// @brief How long a connection may go without input before it is closed.
+constexpr const auto CLIENT_IDLE_TIMEOUT = std::chrono::seconds(60);
+
+/// @brief How long an unterminated command waits for its newline before it
+///        is run anyway, for clients that never send one.
+constexpr const auto UNTERMINATED_LINE_TIMEOUT = std::chrono::milliseconds(200);
+
+/// @brief Shorthand for the BasicTCPServer template header.
+#define TCP_SERVER_TEMPLATE template <typename IoPolicy, typename ThreadingPolicy, typename LogPolicy, typename Handler>
+
+/// @brief Shorthand for the BasicTCPServer type inside member definitions.
+#define TCP_SERVER_TYPE BasicTCPServer<IoPolicy, ThreadingPolicy, LogPolicy, Handler>
+
+/**
+ * @brief Constructs a TCP server.
+ */
+TCP_SERVER_TEMPLATE
+TCP_SERVER_TYPE::BasicTCPServer()
+    : server_mutex_("server"),
+      port_(0),
+      running_(false),
+      command_handler_(nullptr),
+      server_fd_(-1),
+      clients_mutex_("server.clients"),
+      last_session_id_(0),
+      recorder_(nullptr),
+      costs_(nullptr)
+{
+}
+
+/**
+ * @brief Destructor for the TCP server.
+ * @details Ensures proper shutdown and resource cleanup.
+ */
+TCP_SERVER_TEMPLATE
+TCP_SERVER_TYPE::~BasicTCPServer()
+{
+    stop();
+    if (server_thread_.joinable())
+    {
+        // The server thread stopped itself during setup; finish its stop().
+        server_thread_.join();
+        threading_.stop();
+    }
+}
+
+/**
+ * @brief Starts the TCP server.
+ * @details Binds to the specified port and begins listening for connections.
+ *
+ * @param port The port number to listen on.
+ * @param handler Pointer to a user-defined command handler.
+ * @param profile Socket options for the listener and accepted sockets.
+ *
+ * @return True if the server starts successfully, false otherwise.
+ */
+TCP_SERVER_TEMPLATE
+bool TCP_SERVER_TYPE::start(int port, Handler *handler, TCP_ServerCallback cb, TCP_SocketProfile profile)
+{
+    // Store the callback for later use.
+    log_.setCallback(std::move(cb));
+
+    std::lock_guard<TCP_Mutex> lock(server_mutex_);
+    if (running_.load())
+    {
+        callback(Priority::DEBUG, "Server is already running.", false);
+        return false;
+    }
+    if (handler == nullptr)
+    {
+        callback(Priority::ERROR, "Invalid command handler provided.", false);
+        return false;
+    }
+
+    // A server thread that failed during setup called stop() itself, which
+    // could neither join it nor stop the threading policy; do both now so
+    // the thread can be relaunched.
+    if (server_thread_.joinable())
+    {
+        server_thread_.join();
+        threading_.stop();
+    }
+    port_ = port;
+    command_handler_ = handler;
+    tuning_ = TCP_SocketTuning::forProfile(profile);
+    running_.store(true);
+
+    try
+    {
+        // Launch the client workers, then the server thread.
+        threading_.start();
+        server_thread_ = std::thread(&BasicTCPServer::run_server, this);
+    }
+    catch (const std::exception &e)
+    {
+        callback(Priority::ERROR, std::string("Failed to start server thread: ") + e.what(), false);
+        running_.store(false);
+        threading_.stop();
+        return false;
+    }
+    callback(Priority::INFO, "Server started successfully on port " + std::to_string(port_) +
+                                 " (socket profile " + TCP_SocketTuning::name(profile) + ")",
+             true);
+    return true;
+}
+
+/**
+ * @brief Sets the scheduling policy and priority for the server thread.
+ *
+ * @details
+ * Applies a real-time or standard scheduling policy to the server thread
+ * using `pthread_setschedparam()`. This can improve responsiveness
+ * in latency-sensitive use cases, especially when using `SCHED_FIFO` or `SCHED_RR`.
+ *
+ * If the server thread is not running or joinable, this function fails and logs
+ * an error via the configured callback.
+ *
+ * @param schedPolicy Scheduling policy (e.g., `SCHED_FIFO`, `SCHED_RR`, `SCHED_OTHER`).
+ * @param priority Priority value to set for the thread (must be valid for the given policy).
+ *
+ * @return `true` if the scheduling policy and priority were successfully applied.
+ * @return `false` if the server thread is not active or if the operation fails.
+ *
+ * @note
+ * Requires appropriate privileges (e.g., `CAP_SYS_NICE`) to apply real-time policies.
+ */
+TCP_SERVER_TEMPLATE
+bool TCP_SERVER_TYPE::setPriority(int schedPolicy, int priority)
+{
+    // Ensure the server thread is active and joinable
+    if (!running_.load() || !server_thread_.joinable())
+    {
+        callback(Priority::ERROR,
+                 "Server thread is not running. Cannot set priority.",
+                 false);
+        return false;
+    }
+
+    // Prepare scheduling parameters
+    pthread_t nativeHandle = server_thread_.native_handle();
+    sched_param sch_params;
+    sch_params.sched_priority = priority;
+
+    // Apply scheduling policy and priority to the server thread
+    int ret = pthread_setschedparam(nativeHandle, schedPolicy, &sch_params);
+    if (ret != 0)
+    {
+        callback(Priority::ERROR,
+                 "pthread_setschedparam failed: " + std::string(strerror(ret)),
+                 false);
+        return false;
+    }
+
+    callback(Priority::DEBUG,
+             "Thread scheduling set to policy " + std::to_string(schedPolicy) +
+             " with priority " + std::to_string(priority),
+             true);
+
+    return true;
+}
+
+/**
+ * @brief Stops the TCP server.
+ * @details Closes the listening socket, stops the accept loop, and gracefully
+ *          shuts down the server thread. Connected clients are shut down
+ *          and their threads joined, so the server may be destroyed as
+ *          soon as stop() returns.
+ */
+TCP_SERVER_TEMPLATE
+void TCP_SERVER_TYPE::stop()
+{
+    std::lock_guard<TCP_Mutex> lock(server_mutex_);
+    if (!running_.load())
+    {
+        return;
+    }
+    running_.store(false);
+
+    // Close the server socket to unblock accept() if needed.
+    if (server_fd_ != -1)
+    {
+        ::close(server_fd_);
+        server_fd_ = -1;
+    }
+
+    // Wait for the server thread to exit, unless stop() was called from it.
+    if (server_thread_.joinable() && server_thread_.get_id() != std::this_thread::get_id())
+    {
+        server_thread_.join();
+    }
+
+    // Wake connected clients, then wait for every connection's thread to
+    // finish; afterwards none of them touches the server.
+    {
+        std::lock_guard<TCP_Mutex> clients_lock(clients_mutex_);
+        for (int client_socket : client_sockets_)
+        {
+            ::shutdown(client_socket, SHUT_RDWR);
+        }
+    }
+    if (server_thread_.get_id() != std::this_thread::get_id())
+    {
+        threading_.stop();
+    }
+    callback(Priority::INFO, "Server stopped.", true);
+}
+
+/**
+ * @brief Returns a snapshot of the activity counters.
+ * @return Connections accepted, commands handled, and open connections.
+ */
+TCP_SERVER_TEMPLATE
+TCP_ServerStats TCP_SERVER_TYPE::getStats() const
+{
+    TCP_ServerStats stats;
+    stats.connections = static_cast<uint64_t>(stats_.read(STAT_CONNECTIONS));
+    stats.commands = static_cast<uint64_t>(stats_.read(STAT_COMMANDS));
+    stats.active = static_cast<int>(stats_.read(STAT_ACTIVE));
+    return stats;
+}
+
+TCP_SERVER_TEMPLATE
+void TCP_SERVER_TYPE::callback(Priority priority, const std::string &message, bool result)
+{
+    if constexpr (LogPolicy::enabled)
+        log_.log(priority, message, result);
+}
+
+/**
+ * @brief Sets up the listening socket and accepts incoming client connections.
+ * @details The I/O policy decides how the loop waits between accepts; it
+ *          periodically returns so the running flag is re-checked.
+ */
+TCP_SERVER_TEMPLATE
+void TCP_SERVER_TYPE::run_server()
+{
+    // Create the listening socket.
+    server_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (server_fd_ < 0)
+    {
+        callback(Priority::ERROR, "Socket creation failed: " + std::string(strerror(errno)), false);
+        stop();
+        return;
+    }
+
+    // Allow address and port reuse; SO_REUSEPORT lets prefork workers share the port.
+    int opt = 1;
+    if (setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+        setsockopt(server_fd_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+    {
+        callback(Priority::ERROR, "Socket setsockopt failed: " + std::string(strerror(errno)), false);
+        stop();
+        return;
+    }
+
+    // Listener options of the socket profile; buffer sizes must precede listen().
+    if (!tuning_.applyListener(server_fd_))
+    {
+        callback(Priority::WARN, "Some socket profile options were rejected: " + std::string(strerror(errno)), false);
+    }
+
+    // Configure server address.
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    // Restrict to localhost if needed for security.
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Use INADDR_LOOPBACK (127.0.0.1)
+    address.sin_port = htons(port_);
+
+    // Bind the socket.
+    if (bind(server_fd_, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        callback(Priority::ERROR, "Address bind failed: " + std::string(strerror(errno)), false);
+        stop();
+        return;
+    }
+
+    // Start listening.
+    if (listen(server_fd_, MAX_CONNECTIONS) < 0)
+    {
+        callback(Priority::ERROR, "Listen failed: " + std::string(strerror(errno)), false);
+        stop();
+        return;
+    }
+
+    // Let the I/O policy prepare the listening socket once (outside the loop).
+    if (!io_.open(server_fd_))
+    {
+        callback(Priority::ERROR, "I/O policy setup failed: " + std::string(strerror(errno)), false);
+        stop();
+        return;
+    }
+
+    // Main accept loop.
+    while (running_.load())
+    {
+        if (!io_.waitReadable(server_fd_))
+        {
+            continue;
+        }
+
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_socket = accept(server_fd_, reinterpret_cast<struct sockaddr *>(&client_addr), &client_len);
+        if (client_socket < 0)
+        {
+            if (!running_.load())
+            {
+                break;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                io_.onIdle();
+                continue;
+            }
+            callback(Priority::ERROR, "Accept failed: " + std::string(strerror(errno)), false);
+            continue;
+        }
+        callback(Priority::DEBUG, "Client connected.", true);
+        tuning_.applyClient(client_socket);
+        io_.prepareClient(client_socket);
+
+        // The session lives as long as the connection.
+        TCP_Session session;
+        session.id = ++last_session_id_;
+        stats_.add(STAT_CONNECTIONS);
+        char peer[INET_ADDRSTRLEN];
+        if (inet_ntop(AF_INET, &client_addr.sin_addr, peer, sizeof(peer)) != nullptr)
+        {
+            session.peer = std::string(peer) + ":" + std::to_string(ntohs(client_addr.sin_port));
+        }
+
+        // Deferred accept surfaces connections with their first command
+        // already received: answer it here, before any thread handoff.
+        std::string pending;
+        if (tuning_.defer_accept > 0 && serve_inline(client_socket, session, pending))
+        {
+            continue;
+        }
+
+        // Hand the client to the threading policy.
+        threading_.dispatch([this, client_socket, session, pending]() mutable
+                            { handle_client(client_socket, std::move(session), std::move(pending)); });
+    }
+
+    callback(Priority::DEBUG, "Exiting accept loop, cleaning up server socket.", true);
+    io_.close();
+    ::close(server_fd_);
+    server_fd_ = -1;
+}
+
+/**
+ * @brief Answers the commands that arrived with a deferred-accept connection.
+ * @details Runs on the accept thread. Whatever is already readable is
+ *          processed and answered without blocking, as long as the
+ *          handler declares each command quick; the first other command
+ *          and everything after it are left in `pending` for the client's
+ *          thread, so a slow handler never holds up accepting. If the
+ *          client has closed its side (the usual one-shot pattern) after
+ *          quick commands only, the connection is finished here and no
+ *          thread is involved.
+ *
+ * @param client_socket The accepted socket.
+ * @param session The new connection's session.
+ * @param pending Receives the input left for handle_client().
+ * @return True if the connection was finished and closed.
+ */
+TCP_SERVER_TEMPLATE
+bool TCP_SERVER_TYPE::serve_inline(int client_socket, TCP_Session &session, std::string &pending)
+{
+    char buffer[1024];
+    ssize_t bytes_read = ::recv(client_socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (bytes_read < 0)
+    {
+        // Deferral timed out without data; serve the client normally.
+        return false;
+    }
+
+    std::string output;
+    bool finished = bytes_read == 0;
+    if (bytes_read > 0)
+    {
+        pending.assign(buffer, static_cast<size_t>(bytes_read));
+        if (!process_lines(session, pending, output, true))
+        {
+            finished = true;
+        }
+        else if (pending.find('\n') != std::string::npos)
+        {
+            // A command that may block: the client's thread answers it.
+        }
+        else if (pending.size() > MAX_LINE_LENGTH)
+        {
+            session.fail(TCP_Status::LINE_TOO_LONG);
+            session.renderError(output);
+            output += '\n';
+            finished = true;
+        }
+        else if (!pending.empty() && is_quick(pending) &&
+                 ::recv(client_socket, buffer, 1, MSG_DONTWAIT | MSG_PEEK) == 0)
+        {
+            // Half-closed: the remainder is the final command.
+            TCP_AllocTracker::Scope allocs;
+            process_line(session, pending, output);
+            finished = true;
+        }
+        if (!output.empty() && !send_all(client_socket, output))
+        {
+            finished = true;
+        }
+        // A one-shot client that has already read its reply and closed
+        // needs no thread at all.
+        if (!finished && pending.empty() &&
+            ::recv(client_socket, buffer, 1, MSG_DONTWAIT | MSG_PEEK) == 0)
+        {
+            finished = true;
+        }
+    }
+
+    if (finished)
+    {
+        if constexpr (LogPolicy::enabled)
+            callback(Priority::DEBUG, "Client served inline.", true);
+        ::close(client_socket);
+        command_handler_->sessionClosed(session);
+    }
+    return finished;
+}
+
+/**
+ * @brief Handles a client connection.
+ * @param client_socket The socket descriptor for the client.
+ * @param session The connection's session, kept until it closes.
+ * @param pending Input already received but not yet processed.
+ * @details Reads newline-terminated commands until the client disconnects,
+ *          sends nothing for CLIENT_IDLE_TIMEOUT, or the server stops.
+ *          All complete commands received in one read
+ *          are processed in order and their responses sent in one write,
+ *          so clients may pipeline requests. A trailing command without a
+ *          newline is processed when the client half-closes the connection,
+ *          or once no more input has arrived for UNTERMINATED_LINE_TIMEOUT.
+ */
+TCP_SERVER_TEMPLATE
+void TCP_SERVER_TYPE::handle_client(int client_socket, TCP_Session session, std::string pending)
+{
+    {
+        std::lock_guard<TCP_Mutex> lock(clients_mutex_);
+        client_sockets_.insert(client_socket);
+    }
+    stats_.add(STAT_ACTIVE);
+
+    const size_t buffer_size = 1024;
+    char buffer[buffer_size];
+    std::string output;
+
+    // A quiet persistent connection must not hold a thread forever.
+    struct timeval idle = {static_cast<time_t>(CLIENT_IDLE_TIMEOUT.count()), 0};
+    ::setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+
+    // While an unterminated command is pending, wake up soon to run it.
+    bool short_wait = false;
+    auto wait_for_line = [client_socket, &short_wait, &idle](bool unterminated)
+    {
+        if (unterminated == short_wait)
+            return;
+        short_wait = unterminated;
+        struct timeval brief = {0, static_cast<suseconds_t>(
+                                       std::chrono::microseconds(UNTERMINATED_LINE_TIMEOUT).count())};
+        ::setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, unterminated ? &brief : &idle, sizeof(idle));
+    };
+    auto last_input = std::chrono::steady_clock::now();
+
+    // Answer the lines the accept thread left for this thread first.
+    bool open = true;
+    if (pending.find('\n') != std::string::npos)
+    {
+        open = process_lines(session, pending, output);
+        if (!output.empty() && !send_all(client_socket, output))
+        {
+            open = false;
+        }
+    }
+    wait_for_line(!pending.empty());
+
+    while (open && running_.load())
+    {
+        ssize_t bytes_read = ::read(client_socket, buffer, buffer_size);
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            const auto quiet = std::chrono::steady_clock::now() - last_input;
+            if (!pending.empty() && quiet >= UNTERMINATED_LINE_TIMEOUT)
+            {
+                // The client is waiting for a reply to a line it never ended.
+                output.clear();
+                {
+                    TCP_AllocTracker::Scope allocs;
+                    open = process_line(session, pending, output);
+                }
+                pending.clear();
+                wait_for_line(false);
+                if (!send_all(client_socket, output))
+                {
+                    open = false;
+                }
+                continue;
+            }
+            if (quiet >= CLIENT_IDLE_TIMEOUT)
+            {
+                if constexpr (LogPolicy::enabled)
+                    callback(Priority::DEBUG, "Closing idle client.", true);
+                break;
+            }
+            // Non-blocking client socket (see the I/O policy): wait for data.
+            io_.waitClient(client_socket);
+            continue;
+        }
+        if (bytes_read <= 0)
+        {
+            // Treat an unterminated final command as complete on half-close.
+            if (bytes_read == 0 && !pending.empty())
+            {
+                output.clear();
+                TCP_AllocTracker::Scope allocs;
+                process_line(session, pending, output);
+                send_all(client_socket, output);
+            }
+            break;
+        }
+        pending.append(buffer, static_cast<size_t>(bytes_read));
+        last_input = std::chrono::steady_clock::now();
+        tuning_.afterRead(client_socket);
+
+        // Process every complete line, collecting the responses.
+        output.clear();
+        if (!process_lines(session, pending, output))
+        {
+            send_all(client_socket, output);
+            break;
+        }
+
+        if (pending.size() > MAX_LINE_LENGTH)
+        {
+            session.fail(TCP_Status::LINE_TOO_LONG);
+            session.renderError(output);
+            output += '\n';
+            send_all(client_socket, output);
+            break;
+        }
+        if (!output.empty() && !send_all(client_socket, output))
+        {
+            break;
+        }
+        wait_for_line(!pending.empty());
+    }
+
+    {
+        std::lock_guard<TCP_Mutex> lock(clients_mutex_);
+        client_sockets_.erase(client_socket);
+        ::close(client_socket);
+    }
+    command_handler_->sessionClosed(session);
+    stats_.add(STAT_ACTIVE, -1);
+}
+
+/**
+ * @brief Processes every complete line in `pending` and removes it.
+ * @param session The connection's session.
+ * @param pending Received input; keeps any unterminated remainder.
+ * @param output Receives the responses, each followed by a newline.
+ * @param quick_only Stop at the first line whose command is not quick,
+ *                   leaving it and the lines after it in `pending`.
+ * @details Allocations made for each line, including copying it out of
+ *          `pending`, are charged to its command (see TCP_AllocTracker).
+ * @return False if the client exhausted its error budget; the remaining
+ *         input is then discarded.
+ */
+TCP_SERVER_TEMPLATE
+bool TCP_SERVER_TYPE::process_lines(TCP_Session &session, std::string &pending, std::string &output, bool quick_only)
+{
+    size_t start = 0;
+    size_t end;
+    while ((end = pending.find('\n', start)) != std::string::npos)
+    {
+        if (quick_only && !is_quick(pending.substr(start, end - start)))
+        {
+            break;
+        }
+        TCP_AllocTracker::Scope allocs;
+        if (!process_line(session, pending.substr(start, end - start), output))
+        {
+            pending.clear();
+            return false;
+        }
+        start = end + 1;
+    }
+    pending.erase(0, start);
+    return true;
+}
+
+/**
+ * @brief Tells whether the command of a line is quick.
+ * @param line A command line, with or without its terminator.
+ * @return True if the handler declares the line's command quick.
+ */
+TCP_SERVER_TEMPLATE
+bool TCP_SERVER_TYPE::is_quick(const std::string &line) const
+{
+    const size_t begin = line.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+    {
+        // Blank lines are ignored.
+        return true;
+    }
+    const size_t end = line.find_first_of(" \t\r\n", begin);
+    return command_handler_->isQuick(line.substr(begin, end == std::string::npos ? end : end - begin));
+}
+
+/**
+ * @brief Parses and dispatches one command line.
+ * @param session The connection's session.
+ * @param input The command line without its terminator.
+ * @param output Receives the response followed by a newline.
+ * @details Errors reported through `session.fail()` are rendered from
+ *          interned text straight into `output`. A successful command
+ *          resets the session's error budget.
+ * @return False if the client has now sent ERROR_BUDGET consecutive
+ *         commands that failed.
+ */
+TCP_SERVER_TEMPLATE
+bool TCP_SERVER_TYPE::process_line(TCP_Session &session, std::string input, std::string &output)
+{
+    // Trim whitespace from input.
+    input.erase(input.find_last_not_of(" \t\n\r") + 1);
+    input.erase(0, input.find_first_not_of(" \t\n\r"));
+    if (input.empty())
+    {
+        return true;
+    }
+
+    // Parse command and argument.
+    std::string command, arg;
+    auto pos = input.find(' ');
+    if (pos == std::string::npos)
+    {
+        command = input;
+    }
+    else
+    {
+        command = input.substr(0, pos);
+        arg = input.substr(pos + 1);
+    }
+    // The token of `auth` (also `backend:auth` through a proxy) is never
+    // logged or recorded.
+    static const std::string redacted = "(redacted)";
+    const bool secret = command == "auth" ||
+                        (command.size() > 5 && command.compare(command.size() - 5, 5, ":auth") == 0);
+    const std::string &shown_arg = secret ? redacted : arg;
+    if constexpr (LogPolicy::enabled)
+        callback(Priority::INFO, "Received command: '" + command + "', argument: '" + shown_arg + "'", true);
+
+    // Process the command via the command handler.
+    TCP_FlightRecorder::Entry *flight = recorder_ ? recorder_->begin(session.id, command, shown_arg) : nullptr;
+    const uint64_t cpu_started = costs_ ? TCP_CommandCosts::threadCpuNs() : 0;
+    auto started = std::chrono::steady_clock::now();
+    std::string response = command_handler_->handleCommand(session, command, arg);
+    const uint64_t wall_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count());
+    stats_.record(STAT_COMMAND_NS, wall_ns);
+    stats_.add(STAT_COMMANDS);
+
+    // Keep garbage from clients out of the per-command tables.
+    static const std::string unknown_command = "(unknown)";
+    const std::string &name = session.failure() == TCP_Status::UNKNOWN_COMMAND ? unknown_command : command;
+    if (costs_ != nullptr)
+    {
+        costs_->record(name, TCP_CommandCosts::threadCpuNs() - cpu_started, wall_ns);
+    }
+    TCP_AllocTracker::name(name);
+    if (flight != nullptr)
+    {
+        recorder_->finish(flight, session.failure());
+    }
+    if (session.failed())
+    {
+        session.renderError(output);
+        output += '\n';
+        if (++session.consecutive_errors >= ERROR_BUDGET)
+        {
+            if constexpr (LogPolicy::enabled)
+                callback(Priority::WARN, "Client " + session.peer + " exceeded its error budget, disconnecting.", false);
+            return false;
+        }
+        return true;
+    }
+    session.consecutive_errors = 0;
+    if constexpr (LogPolicy::enabled)
+        callback(Priority::DEBUG, "Sending response: '" + response + "'", true);
+
+    // Append newline to delimit the response.
+    output += response;
+    output += '\n';
+    return true;
+}
+
+/**
+ * @brief Sends an entire buffer to a client.
+ * @return True if every byte was sent.
+ */
+TCP_SERVER_TEMPLATE
+bool TCP_SERVER_TYPE::send_all(int client_socket, const std::string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t n = ::send(client_socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                struct pollfd pfd = {client_socket, POLLOUT, 0};
+                if (::poll(&pfd, 1, 1000) > 0)
+                    continue;
+            }
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+#undef TCP_SERVER_TYPE
+#undef TCP_SERVER_TEMPLATE
+
+#endif // TCP_SERVER_TPP
@@ -0,0 +1,342 @@
+/**
+ * @file tcp_server_policies.cpp
+ * @brief Implementation of the non-trivial BasicTCPServer policies.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_server_policies.hpp"
+
+// Standard Includes
+#include <algorithm>
+
+// System Includes
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/// @brief How long a parked wait sleeps before re-checking the running flag.
+constexpr int PARK_TIMEOUT_MS = 100;
+
+/**
+ * @brief Puts a socket into non-blocking mode.
+ * @param fd The socket.
+ * @return True on success, false otherwise.
+ */
+static bool setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Puts the listening socket into non-blocking mode.
+ * @param listen_fd The listening socket.
+ * @return True on success, false otherwise.
+ */
+bool TCP_PollingAccept::open(int listen_fd)
+{
+    return setNonBlocking(listen_fd);
+}
+
+/**
+ * @brief Creates the epoll instance and registers the listening socket.
+ * @param listen_fd The listening socket.
+ * @return True on success, false otherwise.
+ */
+bool TCP_EpollAccept::open(int listen_fd)
+{
+    if (!setNonBlocking(listen_fd))
+    {
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0)
+    {
+        return false;
+    }
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd, &ev) == 0;
+}
+
+/**
+ * @brief Waits up to 100 ms for a pending connection.
+ * @return True if the listening socket is readable.
+ */
+bool TCP_EpollAccept::waitReadable(int)
+{
+    struct epoll_event ev;
+    return epoll_wait(epoll_fd_, &ev, 1, PARK_TIMEOUT_MS) > 0;
+}
+
+/**
+ * @brief Closes the epoll instance.
+ */
+void TCP_EpollAccept::close()
+{
+    if (epoll_fd_ != -1)
+    {
+        ::close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+}
+
+/**
+ * @brief Returns the spin counters accumulated since construction.
+ */
+TCP_BusyPollStats TCP_BusyPollAccept::stats() const
+{
+    TCP_BusyPollStats stats;
+    stats.polls = polls_.load(std::memory_order_relaxed);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.parks = parks_.load(std::memory_order_relaxed);
+    stats.spin_ns = spin_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief Makes the listening socket non-blocking and watches it with epoll.
+ * @param listen_fd The listening socket.
+ * @return True on success, false otherwise.
+ */
+bool TCP_BusyPollAccept::open(int listen_fd)
+{
+    if (!setNonBlocking(listen_fd))
+    {
+        return false;
+    }
+    applyBusyPoll(listen_fd);
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0)
+    {
+        return false;
+    }
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd, &ev) == 0;
+}
+
+/**
+ * @brief Spins for a pending connection, then parks for up to 100 ms.
+ * @return True if the listening socket is readable.
+ */
+bool TCP_BusyPollAccept::waitReadable(int)
+{
+    return spinThenPark([this](int timeout)
+                        {
+                            struct epoll_event ev;
+                            return epoll_wait(epoll_fd_, &ev, 1, timeout) > 0; });
+}
+
+/**
+ * @brief Closes the epoll instance.
+ */
+void TCP_BusyPollAccept::close()
+{
+    if (epoll_fd_ != -1)
+    {
+        ::close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+}
+
+/**
+ * @brief Makes a client socket non-blocking so its reads can be spun on.
+ * @param fd The accepted socket.
+ */
+void TCP_BusyPollAccept::prepareClient(int fd)
+{
+    setNonBlocking(fd);
+    applyBusyPoll(fd);
+}
+
+/**
+ * @brief Spins for client data, then parks for up to 100 ms.
+ * @param fd The client socket.
+ */
+void TCP_BusyPollAccept::waitClient(int fd)
+{
+    spinThenPark([fd](int timeout)
+                 {
+                     struct pollfd pfd = {fd, POLLIN, 0};
+                     return ::poll(&pfd, 1, timeout) > 0; });
+}
+
+/**
+ * @brief Polls `ready` with a zero timeout until the spin window closes,
+ *        then once with the park timeout.
+ * @param ready Callable taking a timeout in ms, true when data is ready.
+ * @return The result of the last call to `ready`.
+ */
+template <typename Ready>
+bool TCP_BusyPollAccept::spinThenPark(Ready &&ready)
+{
+    if (spin_.count() > 0)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        const auto deadline = begin + spin_;
+        uint64_t polls = 0;
+        bool hit = false;
+        auto now = begin;
+        while (!hit && now < deadline)
+        {
+            hit = ready(0);
+            ++polls;
+            now = std::chrono::steady_clock::now();
+        }
+        polls_.fetch_add(polls, std::memory_order_relaxed);
+        spin_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - begin).count(),
+                           std::memory_order_relaxed);
+        if (hit)
+        {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    parks_.fetch_add(1, std::memory_order_relaxed);
+    return ready(PARK_TIMEOUT_MS);
+}
+
+/**
+ * @brief Applies `SO_BUSY_POLL` if configured. Failure is not fatal.
+ * @param fd The socket.
+ */
+void TCP_BusyPollAccept::applyBusyPoll(int fd) const
+{
+    if (busy_poll_us_ > 0)
+    {
+        int usec = busy_poll_us_;
+        setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec));
+    }
+}
+
+/**
+ * @brief Joins every connection thread, waiting for those still running.
+ */
+void TCP_ThreadPerConnection::stop()
+{
+    for (auto &connection : connections_)
+    {
+        if (connection.thread.joinable())
+        {
+            connection.thread.join();
+        }
+    }
+    connections_.clear();
+}
+
+/**
+ * @brief Joins and forgets the connection threads that have finished.
+ */
+void TCP_ThreadPerConnection::reap()
+{
+    for (auto it = connections_.begin(); it != connections_.end();)
+    {
+        if (it->done.load(std::memory_order_acquire))
+        {
+            it->thread.join();
+            it = connections_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Constructs the thread pool without starting any workers.
+ * @param workers Number of worker threads; 0 selects the hardware concurrency.
+ */
+TCP_ThreadPool::TCP_ThreadPool(std::size_t workers)
+    : worker_count_(workers ? workers : std::max(1u, std::thread::hardware_concurrency())),
+      tasks_mutex_("pool")
+{
+}
+
+/**
+ * @brief Stops and joins all workers.
+ */
+TCP_ThreadPool::~TCP_ThreadPool()
+{
+    stop();
+}
+
+/**
+ * @brief Launches the worker threads.
+ */
+void TCP_ThreadPool::start()
+{
+    std::lock_guard<TCP_Mutex> lock(tasks_mutex_);
+    stopping_ = false;
+    while (workers_.size() < worker_count_)
+    {
+        workers_.emplace_back(&TCP_ThreadPool::worker, this);
+    }
+}
+
+/**
+ * @brief Lets the workers drain the queue, then joins them.
+ */
+void TCP_ThreadPool::stop()
+{
+    {
+        std::lock_guard<TCP_Mutex> lock(tasks_mutex_);
+        stopping_ = true;
+    }
+    tasks_cv_.notify_all();
+    for (auto &worker : workers_)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+/**
+ * @brief Queues a task for the next free worker.
+ * @param task The task to run.
+ */
+void TCP_ThreadPool::dispatch(std::function<void()> task)
+{
+    {
+        std::lock_guard<TCP_Mutex> lock(tasks_mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    tasks_cv_.notify_one();
+}
+
+/**
+ * @brief Worker loop: runs queued tasks until the pool is stopped.
+ */
+void TCP_ThreadPool::worker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<TCP_Mutex> lock(tasks_mutex_);
+            tasks_cv_.wait(lock, [this]
+                           { return !tasks_.empty() || stopping_; });
+            if (stopping_ && tasks_.empty())
+                break;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,336 @@
+/**
+ * @file tcp_server_policies.hpp
+ * @brief Compile-time policies for the BasicTCPServer template.
+ * @details This file defines the I/O, threading, and logging policies that
+ *          select the behavior of BasicTCPServer at compile time. Each policy
+ *          is a small concrete class; the server holds one instance of each
+ *          and calls it non-virtually so the compiler can inline or remove
+ *          the calls entirely.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_SERVER_POLICIES_HPP
+#define TCP_SERVER_POLICIES_HPP
+
+// Project includes
+#include "tcp_mutex.hpp"
+
+// Standard includes
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Callback priorities reported by the server. Matches those in LCBLog.
+ * @details Declared outside of the server template so that every
+ *          instantiation and every log policy shares a single type.
+ *          Exposed as `TCP_Server::Priority` for existing code.
+ */
+enum class TCP_ServerPriority
+{
+    DEBUG = 0, ///< Debug-level messages for detailed troubleshooting.
+    INFO,      ///< Informational messages for general system state.
+    WARN,      ///< Warnings indicating potential issues.
+    ERROR,     ///< Errors that require attention but allow continued execution.
+    FATAL      ///< Critical errors that result in program termination.
+};
+
+/// @brief Signature of the user-supplied server event callback.
+using TCP_ServerCallback = std::function<void(TCP_ServerPriority, const std::string &, bool)>;
+
+/**
+ * @name I/O Policies
+ * @brief Decide how the server waits for connections and client data.
+ * @details An I/O policy provides:
+ *          - `bool open(int listen_fd)` called once after `listen()`.
+ *          - `bool waitReadable(int listen_fd)` called before each `accept()`;
+ *            returns false when the wait timed out so the caller can re-check
+ *            its running flag.
+ *          - `void onIdle()` called when `accept()` reported `EAGAIN`.
+ *          - `void close()` called when the accept loop exits.
+ *          - `void prepareClient(int fd)` called for each accepted socket.
+ *          - `void waitClient(int fd)` called when a read on a client
+ *            socket reported `EAGAIN`; may return early on timeout.
+ */
+///@{
+
+/**
+ * @class TCP_PollingAccept
+ * @brief Non-blocking accept with a fixed sleep when idle.
+ * @details This is the historical behavior of TCP_Server: the listening
+ *          socket is non-blocking and the loop sleeps 100 ms whenever no
+ *          connection is pending.
+ */
+class TCP_PollingAccept
+{
+public:
+    bool open(int listen_fd);
+    bool waitReadable(int) { return true; }
+    void onIdle() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }
+    void close() {}
+    void prepareClient(int) {}
+    void waitClient(int) {}
+};
+
+/**
+ * @class TCP_EpollAccept
+ * @brief Waits for connections with `epoll_wait()`.
+ * @details New connections wake the accept loop immediately instead of after
+ *          up to 100 ms. The wait still times out periodically so a stop
+ *          request is noticed.
+ */
+class TCP_EpollAccept
+{
+public:
+    TCP_EpollAccept() = default;
+    ~TCP_EpollAccept() { close(); }
+
+    TCP_EpollAccept(const TCP_EpollAccept &) = delete;
+    TCP_EpollAccept &operator=(const TCP_EpollAccept &) = delete;
+
+    bool open(int listen_fd);
+    bool waitReadable(int listen_fd);
+    void onIdle() {}
+    void close();
+    void prepareClient(int) {}
+    void waitClient(int) {}
+
+private:
+    /// @brief The epoll instance watching the listening socket.
+    int epoll_fd_ = -1;
+};
+
+/**
+ * @struct TCP_BusyPollStats
+ * @brief Counters showing what busy polling costs and what it catches.
+ * @details `spin_ns` approximates the CPU time burned spinning; `hits` are
+ *          waits satisfied while spinning (served without a wakeup), and
+ *          `parks` are waits that gave up spinning and slept.
+ */
+struct TCP_BusyPollStats
+{
+    uint64_t polls = 0;   ///< Zero-timeout polls issued while spinning.
+    uint64_t hits = 0;    ///< Waits that found data while spinning.
+    uint64_t parks = 0;   ///< Waits that fell back to sleeping.
+    uint64_t spin_ns = 0; ///< Total time spent spinning.
+};
+
+/**
+ * @class TCP_BusyPollAccept
+ * @brief Spins on non-blocking sockets before parking, for dedicated cores.
+ * @details Both the accept loop and every client connection poll with a
+ *          zero timeout for up to the spin window, then park in a blocking
+ *          wait of up to 100 ms. This removes the wakeup latency from the
+ *          request path at the price of a busy core per active thread, so
+ *          combine it with `setPriority()` and CPU isolation. Optionally
+ *          sets `SO_BUSY_POLL` so the kernel also polls the device queue.
+ *
+ *          Configure with setSpin() and setBusyPoll() while the server is
+ *          stopped; read the cost and benefit with stats().
+ */
+class TCP_BusyPollAccept
+{
+public:
+    TCP_BusyPollAccept() = default;
+    ~TCP_BusyPollAccept() { close(); }
+
+    TCP_BusyPollAccept(const TCP_BusyPollAccept &) = delete;
+    TCP_BusyPollAccept &operator=(const TCP_BusyPollAccept &) = delete;
+
+    /**
+     * @brief Sets how long a wait spins before parking.
+     * @param spin The spin window; zero parks immediately. Default 200 us.
+     */
+    void setSpin(std::chrono::microseconds spin) { spin_ = spin; }
+
+    /**
+     * @brief Sets `SO_BUSY_POLL` on all sockets.
+     * @param usec Microseconds the kernel may busy poll; 0 leaves it unset.
+     *             Values above `net.core.busy_read` need `CAP_NET_ADMIN`.
+     */
+    void setBusyPoll(int usec) { busy_poll_us_ = usec; }
+
+    /// @brief Returns the spin counters accumulated since construction.
+    TCP_BusyPollStats stats() const;
+
+    bool open(int listen_fd);
+    bool waitReadable(int listen_fd);
+    void onIdle() {}
+    void close();
+    void prepareClient(int fd);
+    void waitClient(int fd);
+
+private:
+    /// @brief The epoll instance watching the listening socket.
+    int epoll_fd_ = -1;
+
+    std::chrono::microseconds spin_{200};
+    int busy_poll_us_ = 0;
+
+    std::atomic<uint64_t> polls_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> parks_{0};
+    std::atomic<uint64_t> spin_ns_{0};
+
+    /// @brief Spins on `ready(0)`, then parks in `ready(100)`.
+    template <typename Ready>
+    bool spinThenPark(Ready &&ready);
+
+    /// @brief Applies `SO_BUSY_POLL` if configured.
+    void applyBusyPoll(int fd) const;
+};
+///@}
+
+/**
+ * @name Threading Policies
+ * @brief Decide which thread runs a client connection.
+ * @details A threading policy provides `start()`, `stop()`, and
+ *          `dispatch(task)`, where `task` is a callable taking no arguments.
+ */
+///@{
+
+/**
+ * @class TCP_ThreadPerConnection
+ * @brief Runs every client connection on its own thread.
+ * @details This is the historical behavior of TCP_Server. The threads are
+ *          kept so stop() can join them: once it returns no connection
+ *          still uses the server. Finished threads are joined on the next
+ *          dispatch(). dispatch() and stop() are called from one thread
+ *          at a time (the accept loop, then stop()).
+ */
+class TCP_ThreadPerConnection
+{
+public:
+    TCP_ThreadPerConnection() = default;
+    ~TCP_ThreadPerConnection() { stop(); }
+
+    TCP_ThreadPerConnection(const TCP_ThreadPerConnection &) = delete;
+    TCP_ThreadPerConnection &operator=(const TCP_ThreadPerConnection &) = delete;
+
+    void start() {}
+    void stop();
+
+    template <typename Task>
+    void dispatch(Task &&task)
+    {
+        reap();
+        Connection &connection = connections_.emplace_back();
+        connection.thread = std::thread([&connection, task = std::forward<Task>(task)]() mutable
+                                        {
+                                            task();
+                                            connection.done.store(true, std::memory_order_release); });
+    }
+
+private:
+    /// @brief A connection thread; list nodes keep `done` at a fixed address.
+    struct Connection
+    {
+        std::thread thread;
+        std::atomic<bool> done{false};
+    };
+
+    std::list<Connection> connections_;
+
+    /// @brief Joins and forgets the threads that have finished.
+    void reap();
+};
+
+/**
+ * @class TCP_ThreadPool
+ * @brief Runs client connections on a fixed set of worker threads.
+ * @details Avoids thread creation per connection. Connections beyond the
+ *          number of workers wait in a FIFO queue until a worker is free.
+ */
+class TCP_ThreadPool
+{
+public:
+    /**
+     * @brief Constructs the pool.
+     * @param workers Number of worker threads; 0 selects the hardware
+     *                concurrency.
+     */
+    explicit TCP_ThreadPool(std::size_t workers = 0);
+    ~TCP_ThreadPool();
+
+    TCP_ThreadPool(const TCP_ThreadPool &) = delete;
+    TCP_ThreadPool &operator=(const TCP_ThreadPool &) = delete;
+
+    void start();
+    void stop();
+    void dispatch(std::function<void()> task);
+
+private:
+    std::size_t worker_count_;
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    TCP_Mutex tasks_mutex_;
+    std::condition_variable_any tasks_cv_;
+    bool stopping_ = false;
+
+    void worker();
+};
+///@}
+
+/**
+ * @name Log Policies
+ * @brief Decide what happens to server event messages.
+ * @details A log policy provides `setCallback(cb)`, `log(priority, msg, ok)`,
+ *          and a `static constexpr bool enabled`. The server skips building
+ *          messages altogether when `enabled` is false.
+ */
+///@{
+
+/**
+ * @class TCP_CallbackLog
+ * @brief Forwards server events to the callback passed to `start()`.
+ * @details This is the historical behavior of TCP_Server.
+ */
+class TCP_CallbackLog
+{
+public:
+    static constexpr bool enabled = true;
+
+    void setCallback(TCP_ServerCallback cb)
+    {
+        if (cb)
+            callback_ = std::move(cb);
+    }
+
+    void log(TCP_ServerPriority priority, const std::string &message, bool result) const
+    {
+        if (callback_)
+            callback_(priority, message, result);
+    }
+
+private:
+    TCP_ServerCallback callback_;
+};
+
+/**
+ * @class TCP_NullLog
+ * @brief Discards all server events at compile time.
+ */
+class TCP_NullLog
+{
+public:
+    static constexpr bool enabled = false;
+
+    void setCallback(const TCP_ServerCallback &) {}
+    void log(TCP_ServerPriority, const std::string &, bool) const {}
+};
+///@}
+
+#endif // TCP_SERVER_POLICIES_HPP
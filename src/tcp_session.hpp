@@ -0,0 +1,137 @@
+/**
+ * @file tcp_session.hpp
+ * @brief Per-connection session state passed to command handlers.
+ * @details This file defines TCP_Session, which the server creates when a
+ *          client connects and passes to every command from that client.
+ *          Settings negotiated once (protocol, verbosity) and state kept
+ *          between commands (subscriptions) live here instead of being
+ *          re-derived on every request.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_SESSION_HPP
+#define TCP_SESSION_HPP
+
+// Project includes
+#include "tcp_reply.hpp"
+
+// Standard includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Reply formats a client can negotiate.
+ */
+enum class TCP_Protocol
+{
+    TEXT = 0, ///< Human-readable replies; the historical format.
+    TERSE     ///< Numeric status codes and bare values (see tcp_reply.hpp).
+};
+
+/**
+ * @struct TCP_Session
+ * @brief State of one client connection.
+ * @details Owned by the server for the lifetime of the connection and only
+ *          touched by the thread serving it, so handlers need no locking.
+ *          Commands that do not arrive over a connection (direct calls to
+ *          the two-argument `handleCommand()`) get a fresh default session.
+ */
+struct TCP_Session
+{
+    uint64_t id = 0;                            ///< Client ID, unique per server; 0 if none.
+    std::string peer;                           ///< Remote "address:port", if known.
+    TCP_Protocol protocol = TCP_Protocol::TEXT; ///< Negotiated reply format.
+    int verbosity = 1;                          ///< 0 short help text, 1 normal.
+    int auth_level = 0;                         ///< AUTH_ADMIN once `auth` succeeded.
+
+    /// @brief Watched parameters and the store version last reported.
+    std::unordered_map<std::string, uint64_t> subscriptions;
+
+    /// @brief Errors since the last successful command (see the error budget).
+    unsigned consecutive_errors = 0;
+
+    /// @brief auth_level that allows administrative commands.
+    static constexpr int AUTH_ADMIN = 1;
+
+    /// @brief True if replies should use the terse protocol.
+    bool terse() const { return protocol == TCP_Protocol::TERSE; }
+
+    /// @brief True if the client may run administrative commands.
+    bool admin() const { return auth_level >= AUTH_ADMIN; }
+
+    /**
+     * @brief Grants AUTH_ADMIN if `given` matches the server's token.
+     * @details The comparison takes the same time wherever the first
+     *          difference is. An empty `token` (none configured) never
+     *          matches, so administrative commands are then disabled.
+     *
+     * @param token The token the server was configured with.
+     * @param given The token the client sent.
+     * @return True if the client is now authenticated.
+     */
+    bool authenticate(const std::string &token, const std::string &given)
+    {
+        unsigned char difference = token.size() != given.size() ? 1 : 0;
+        for (std::size_t i = 0; i < token.size(); ++i)
+        {
+            difference |= static_cast<unsigned char>(token[i] ^ (i < given.size() ? given[i] : 0));
+        }
+        if (token.empty() || difference != 0)
+        {
+            return false;
+        }
+        auth_level = AUTH_ADMIN;
+        return true;
+    }
+
+    /**
+     * @brief Reports an error for the current command.
+     * @details The handler then returns an empty string and the server
+     *          renders the interned error reply. At most ERROR_TOKEN_SIZE
+     *          bytes of `token` are kept, so junk input costs no allocation.
+     *
+     * @param status The error status.
+     * @param token The offending command or argument, if any.
+     */
+    void fail(TCP_Status status, const std::string &token = std::string())
+    {
+        error = status;
+        error_length = std::min(token.size(), sizeof(error_token));
+        error_truncated = token.size() > sizeof(error_token);
+        std::memcpy(error_token, token.data(), error_length);
+    }
+
+    /// @brief True if the current command reported an error.
+    bool failed() const { return error != TCP_Status::OK; }
+
+    /// @brief The current command's error status, TCP_Status::OK if none.
+    TCP_Status failure() const { return error; }
+
+    /**
+     * @brief Appends the pending error reply to `output` and clears it.
+     * @param output The output buffer.
+     */
+    void renderError(std::string &output)
+    {
+        TCP_Reply::appendError(output, terse(), error, error_token, error_length, error_truncated);
+        error = TCP_Status::OK;
+    }
+
+private:
+    /// @brief Longest token quoted in an error reply.
+    static constexpr std::size_t ERROR_TOKEN_SIZE = 32;
+
+    TCP_Status error = TCP_Status::OK;
+    char error_token[ERROR_TOKEN_SIZE];
+    std::size_t error_length = 0;
+    bool error_truncated = false;
+};
+
+#endif // TCP_SESSION_HPP
@@ -0,0 +1,154 @@
+/**
+ * @file tcp_socket_profile.cpp
+ * @brief Implementation of the socket tuning profiles.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_socket_profile.hpp"
+
+// System Includes
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Sets an integer socket option.
+ * @return True on success.
+ */
+static bool setOption(int fd, int level, int option, int value)
+{
+    return setsockopt(fd, level, option, &value, sizeof(value)) == 0;
+}
+
+/**
+ * @brief Returns the options for a named profile.
+ * @param profile The profile.
+ * @return The profile's options.
+ */
+TCP_SocketTuning TCP_SocketTuning::forProfile(TCP_SocketProfile profile)
+{
+    TCP_SocketTuning tuning;
+    switch (profile)
+    {
+    case TCP_SocketProfile::LATENCY:
+        // Replies are complete lines: send them at once, ACK at once, and
+        // let returning clients carry their first command in the SYN.
+        tuning.nodelay = true;
+        tuning.quickack = true;
+        tuning.defer_accept = 1;
+        tuning.fastopen = 16;
+        break;
+    case TCP_SocketProfile::THROUGHPUT:
+        // Large windows for clients that pipeline many commands. Replies
+        // are already coalesced per read, so Nagle would only hold back
+        // the tail of a batch until the peer's delayed ACK.
+        tuning.nodelay = true;
+        tuning.rcvbuf = 256 * 1024;
+        tuning.sndbuf = 256 * 1024;
+        break;
+    case TCP_SocketProfile::MEMORY:
+        // Commands and replies are short; small buffers suffice, and a
+        // connection costs nothing until its first command arrives.
+        tuning.nodelay = true;
+        tuning.defer_accept = 1;
+        tuning.rcvbuf = 4096;
+        tuning.sndbuf = 4096;
+        break;
+    case TCP_SocketProfile::DEFAULT:
+    default:
+        break;
+    }
+    return tuning;
+}
+
+/**
+ * @brief Parses a profile name.
+ * @param name The profile name.
+ * @param profile Receives the profile.
+ * @return False if the name is unknown.
+ */
+bool TCP_SocketTuning::parse(const std::string &name, TCP_SocketProfile &profile)
+{
+    for (auto candidate : {TCP_SocketProfile::DEFAULT, TCP_SocketProfile::LATENCY,
+                           TCP_SocketProfile::THROUGHPUT, TCP_SocketProfile::MEMORY})
+    {
+        if (name == TCP_SocketTuning::name(candidate))
+        {
+            profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the lower-case name of a profile.
+ */
+const char *TCP_SocketTuning::name(TCP_SocketProfile profile)
+{
+    switch (profile)
+    {
+    case TCP_SocketProfile::LATENCY:
+        return "latency";
+    case TCP_SocketProfile::THROUGHPUT:
+        return "throughput";
+    case TCP_SocketProfile::MEMORY:
+        return "memory";
+    case TCP_SocketProfile::DEFAULT:
+    default:
+        return "default";
+    }
+}
+
+/**
+ * @brief Applies the listener options; call before `listen()`.
+ * @details Buffer sizes are set here so accepted sockets inherit them and
+ *          the window scale is negotiated accordingly.
+ *
+ * @param fd The listening socket.
+ * @return False if any option was rejected.
+ */
+bool TCP_SocketTuning::applyListener(int fd) const
+{
+    bool ok = true;
+    if (rcvbuf > 0)
+        ok = setOption(fd, SOL_SOCKET, SO_RCVBUF, rcvbuf) && ok;
+    if (sndbuf > 0)
+        ok = setOption(fd, SOL_SOCKET, SO_SNDBUF, sndbuf) && ok;
+    if (defer_accept > 0)
+        ok = setOption(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, defer_accept) && ok;
+    if (fastopen > 0)
+        ok = setOption(fd, IPPROTO_TCP, TCP_FASTOPEN, fastopen) && ok;
+    return ok;
+}
+
+/**
+ * @brief Applies the per-connection options to an accepted socket.
+ * @param fd The accepted socket.
+ * @return False if any option was rejected.
+ */
+bool TCP_SocketTuning::applyClient(int fd) const
+{
+    bool ok = true;
+    if (nodelay)
+        ok = setOption(fd, IPPROTO_TCP, TCP_NODELAY, 1) && ok;
+    if (quickack)
+        ok = setOption(fd, IPPROTO_TCP, TCP_QUICKACK, 1) && ok;
+    if (rcvlowat > 0)
+        ok = setOption(fd, SOL_SOCKET, SO_RCVLOWAT, rcvlowat) && ok;
+    return ok;
+}
+
+/**
+ * @brief Re-arms TCP_QUICKACK after a read, if enabled.
+ * @param fd The client socket.
+ */
+void TCP_SocketTuning::afterRead(int fd) const
+{
+    if (quickack)
+        setOption(fd, IPPROTO_TCP, TCP_QUICKACK, 1);
+}
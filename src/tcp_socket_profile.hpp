@@ -0,0 +1,94 @@
+/**
+ * @file tcp_socket_profile.hpp
+ * @brief Named socket option profiles for the server.
+ * @details This file defines TCP_SocketProfile and TCP_SocketTuning, which
+ *          group TCP options into coherent sets tuned for latency,
+ *          throughput, or memory use. A profile is selected at
+ *          `BasicTCPServer::start()` and applied to the listening socket
+ *          and to every accepted socket.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_SOCKET_PROFILE_HPP
+#define TCP_SOCKET_PROFILE_HPP
+
+// Standard includes
+#include <string>
+
+/**
+ * @brief Named socket tuning profiles.
+ */
+enum class TCP_SocketProfile
+{
+    DEFAULT = 0, ///< Kernel defaults; the historical behavior.
+    LATENCY,     ///< Small replies out at once, immediate ACKs, TFO.
+    THROUGHPUT,  ///< Large buffers for pipelined bulk traffic.
+    MEMORY       ///< Small buffers; no thread until a request arrives.
+};
+
+/**
+ * @struct TCP_SocketTuning
+ * @brief The socket options making up a profile.
+ * @details Zero or false means "leave the kernel default".
+ *
+ *          `rcvlowat` is available for custom tunings but no built-in
+ *          profile sets it: a command line can be shorter than any useful
+ *          watermark, and a blocking read would then wait for the next one.
+ */
+struct TCP_SocketTuning
+{
+    bool nodelay = false;  ///< TCP_NODELAY on accepted sockets.
+    bool quickack = false; ///< TCP_QUICKACK, re-armed after every read.
+    int defer_accept = 0;  ///< TCP_DEFER_ACCEPT seconds on the listener.
+    int fastopen = 0;      ///< TCP_FASTOPEN queue length on the listener.
+    int rcvbuf = 0;        ///< SO_RCVBUF bytes (listener, inherited).
+    int sndbuf = 0;        ///< SO_SNDBUF bytes (listener, inherited).
+    int rcvlowat = 0;      ///< SO_RCVLOWAT bytes on accepted sockets.
+
+    /**
+     * @brief Returns the options for a named profile.
+     * @param profile The profile.
+     * @return The profile's options.
+     */
+    static TCP_SocketTuning forProfile(TCP_SocketProfile profile);
+
+    /**
+     * @brief Parses "default", "latency", "throughput" or "memory".
+     * @param name The profile name.
+     * @param profile Receives the profile.
+     * @return False if the name is unknown.
+     */
+    static bool parse(const std::string &name, TCP_SocketProfile &profile);
+
+    /**
+     * @brief Returns the lower-case name of a profile.
+     */
+    static const char *name(TCP_SocketProfile profile);
+
+    /**
+     * @brief Applies the listener options; call before `listen()`.
+     * @param fd The listening socket.
+     * @return False if any option was rejected (the rest are still set).
+     */
+    bool applyListener(int fd) const;
+
+    /**
+     * @brief Applies the per-connection options to an accepted socket.
+     * @param fd The accepted socket.
+     * @return False if any option was rejected (the rest are still set).
+     */
+    bool applyClient(int fd) const;
+
+    /**
+     * @brief Re-arms TCP_QUICKACK after a read, if enabled.
+     * @details The kernel clears quick-ACK mode on its own, so it only
+     *          lasts if set again after each read.
+     */
+    void afterRead(int fd) const;
+};
+
+#endif // TCP_SOCKET_PROFILE_HPP
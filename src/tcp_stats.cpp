@@ -0,0 +1,266 @@
+/**
+ * @file tcp_stats.cpp
+ * @brief Implementation of the per-thread sharded statistics.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#include "tcp_stats.hpp"
+
+// Standard Includes
+#include <mutex>
+#include <unordered_set>
+
+/**
+ * @struct TCP_Stats::Shard
+ * @brief One thread's counters and histograms, on their own cache lines.
+ * @details Only the owning thread writes, so updates are a relaxed load
+ *          and store; the atomics only keep concurrent reads well defined.
+ */
+struct alignas(64) TCP_Stats::Shard
+{
+    std::atomic<int64_t> counters[COUNTERS] = {};
+    std::atomic<uint64_t> counts[HISTOGRAMS] = {};
+    std::atomic<uint64_t> sums[HISTOGRAMS] = {};
+    std::atomic<uint64_t> buckets[HISTOGRAMS][BUCKETS] = {};
+    std::atomic<bool> owned{true}; ///< False once its thread exited.
+    Shard *next = nullptr;         ///< Next shard in TCP_Stats::shards_.
+};
+
+/// @brief Adds to a single-writer atomic without a locked instruction.
+template <typename T, typename D>
+static inline void bump(std::atomic<T> &value, D delta)
+{
+    value.store(value.load(std::memory_order_relaxed) + static_cast<T>(delta), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Stats objects still alive, by ID.
+ * @details Threads release their shards on exit only if the stats they
+ *          belong to still exist. Never destroyed, so threads that exit
+ *          during static destruction still find it.
+ */
+static std::mutex &registryMutex()
+{
+    static std::mutex *mutex = new std::mutex;
+    return *mutex;
+}
+
+static std::unordered_set<uint64_t> &registry()
+{
+    static std::unordered_set<uint64_t> *live = new std::unordered_set<uint64_t>;
+    return *live;
+}
+
+/**
+ * @struct TCP_StatsThread
+ * @brief The calling thread's shards, one per stats object it updated.
+ */
+struct TCP_StatsThread
+{
+    /// @brief Stats objects a thread can update before the oldest is evicted.
+    static constexpr std::size_t CACHE = 16;
+
+    struct Entry
+    {
+        uint64_t id;
+        TCP_Stats::Shard *shard;
+    };
+
+    Entry cache[CACHE] = {};
+    std::size_t used = 0;
+
+    /// @brief Hands a shard back for reuse, unless its stats are gone.
+    static void release(const Entry &entry)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        if (registry().count(entry.id) != 0)
+        {
+            entry.shard->owned.store(false, std::memory_order_release);
+        }
+    }
+
+    ~TCP_StatsThread()
+    {
+        for (std::size_t i = 0; i < used; ++i)
+        {
+            release(cache[i]);
+        }
+    }
+};
+
+static thread_local TCP_StatsThread tls_stats;
+
+/// @brief Source of TCP_Stats IDs.
+static std::atomic<uint64_t> next_stats_id{1};
+
+/**
+ * @brief Estimates a percentile.
+ * @param fraction Percentile as a fraction, e.g. 0.99.
+ * @return Upper bound of the bucket holding it, 0 if empty.
+ */
+uint64_t TCP_Stats::Histogram::percentile(double fraction) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(count));
+    uint64_t seen = 0;
+    for (std::size_t b = 0; b < BUCKETS; ++b)
+    {
+        seen += buckets[b];
+        if (seen > rank)
+        {
+            return b == 0 ? 0 : (uint64_t{1} << b) - 1;
+        }
+    }
+    return (uint64_t{1} << (BUCKETS - 1)) - 1;
+}
+
+TCP_Stats::TCP_Stats()
+    : id_(next_stats_id.fetch_add(1, std::memory_order_relaxed)),
+      shards_(nullptr)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().insert(id_);
+}
+
+TCP_Stats::~TCP_Stats()
+{
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().erase(id_);
+    }
+    Shard *shard = shards_.load(std::memory_order_acquire);
+    while (shard != nullptr)
+    {
+        Shard *next = shard->next;
+        delete shard;
+        shard = next;
+    }
+}
+
+TCP_Stats::Shard &TCP_Stats::shard()
+{
+    for (std::size_t i = 0; i < tls_stats.used; ++i)
+    {
+        if (tls_stats.cache[i].id == id_)
+        {
+            return *tls_stats.cache[i].shard;
+        }
+    }
+
+    // First update from this thread: evict the oldest entry if needed.
+    if (tls_stats.used == TCP_StatsThread::CACHE)
+    {
+        TCP_StatsThread::release(tls_stats.cache[0]);
+        for (std::size_t i = 1; i < TCP_StatsThread::CACHE; ++i)
+        {
+            tls_stats.cache[i - 1] = tls_stats.cache[i];
+        }
+        --tls_stats.used;
+    }
+    Shard *claimed = claim();
+    tls_stats.cache[tls_stats.used++] = {id_, claimed};
+    return *claimed;
+}
+
+TCP_Stats::Shard *TCP_Stats::claim()
+{
+    for (Shard *shard = shards_.load(std::memory_order_acquire); shard != nullptr; shard = shard->next)
+    {
+        bool owned = false;
+        if (!shard->owned.load(std::memory_order_relaxed) &&
+            shard->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+        {
+            return shard;
+        }
+    }
+    Shard *shard = new Shard();
+    shard->next = shards_.load(std::memory_order_relaxed);
+    while (!shards_.compare_exchange_weak(shard->next, shard, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    return shard;
+}
+
+/**
+ * @brief Adds to a counter on the calling thread's shard.
+ * @param counter Counter index.
+ * @param delta Amount to add.
+ */
+void TCP_Stats::add(std::size_t counter, int64_t delta)
+{
+    bump(shard().counters[counter], delta);
+}
+
+/**
+ * @brief Records a value in a histogram on the calling thread's shard.
+ * @param histogram Histogram index.
+ * @param value The value.
+ */
+void TCP_Stats::record(std::size_t histogram, uint64_t value)
+{
+    std::size_t bucket = value == 0 ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(value));
+    if (bucket >= BUCKETS)
+    {
+        bucket = BUCKETS - 1;
+    }
+    Shard &s = shard();
+    bump(s.counts[histogram], 1);
+    bump(s.sums[histogram], value);
+    bump(s.buckets[histogram][bucket], 1);
+}
+
+/**
+ * @brief Sums a counter over all shards.
+ * @param counter Counter index.
+ * @return The total.
+ */
+int64_t TCP_Stats::read(std::size_t counter) const
+{
+    int64_t total = 0;
+    for (Shard *shard = shards_.load(std::memory_order_acquire); shard != nullptr; shard = shard->next)
+    {
+        total += shard->counters[counter].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Sums a histogram over all shards.
+ * @param histogram Histogram index.
+ * @return The combined histogram.
+ */
+TCP_Stats::Histogram TCP_Stats::histogram(std::size_t histogram) const
+{
+    Histogram result;
+    for (Shard *shard = shards_.load(std::memory_order_acquire); shard != nullptr; shard = shard->next)
+    {
+        result.count += shard->counts[histogram].load(std::memory_order_relaxed);
+        result.sum += shard->sums[histogram].load(std::memory_order_relaxed);
+        for (std::size_t b = 0; b < BUCKETS; ++b)
+        {
+            result.buckets[b] += shard->buckets[histogram][b].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Counts the shards allocated so far.
+ * @return The number of shards.
+ */
+std::size_t TCP_Stats::shards() const
+{
+    std::size_t count = 0;
+    for (Shard *shard = shards_.load(std::memory_order_acquire); shard != nullptr; shard = shard->next)
+    {
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file tcp_stats.hpp
+ * @brief Per-thread sharded counters and histograms, summed on read.
+ * @details This file defines TCP_Stats, the accounting primitive for hot
+ *          paths. A shared atomic counter touched on every request makes
+ *          each core take the cache line in turn; TCP_Stats instead gives
+ *          every thread its own cache-line-aligned shard, which only that
+ *          thread writes (a plain load and store, no locked instruction).
+ *          Readers sum the shards, so reads are slower and see a value that
+ *          may be a few updates behind, which is fine for statistics.
+ *
+ *          Counters are signed, so a gauge such as open connections can be
+ *          incremented on one thread and decremented on another. Histograms
+ *          have power-of-two buckets, suited to latencies in nanoseconds.
+ *
+ *          A thread's shard is handed to the next new thread when it exits,
+ *          keeping its values, so thread-per-connection servers do not
+ *          accumulate shards.
+ *
+ * @copyright Copyright (c) 2025 Lee C. Bussy (@lbussy)
+ * @license MIT License (see LICENSE file for details)
+ *
+ * @see https://github.com/lbussy/TCP-Server
+ */
+
+#ifndef TCP_STATS_HPP
+#define TCP_STATS_HPP
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class TCP_Stats
+ * @brief A fixed set of counters and histograms with one shard per thread.
+ * @details Counters and histograms are identified by index; the owner
+ *          names them (see TCP_ServerCounter).
+ */
+class TCP_Stats
+{
+public:
+    /// @brief Number of counters.
+    static constexpr std::size_t COUNTERS = 8;
+
+    /// @brief Number of histograms.
+    static constexpr std::size_t HISTOGRAMS = 4;
+
+    /// @brief Histogram buckets; bucket `b` counts values below 2^b.
+    static constexpr std::size_t BUCKETS = 40;
+
+    /**
+     * @struct Histogram
+     * @brief A histogram summed over all threads.
+     */
+    struct Histogram
+    {
+        uint64_t count = 0;             ///< Values recorded.
+        uint64_t sum = 0;               ///< Sum of the values.
+        uint64_t buckets[BUCKETS] = {}; ///< Values in [2^(b-1), 2^b); bucket 0 holds 0.
+
+        /**
+         * @brief Estimates a percentile.
+         * @param fraction Percentile as a fraction, e.g. 0.99.
+         * @return Upper bound of the bucket holding it, 0 if empty.
+         */
+        uint64_t percentile(double fraction) const;
+
+        /// @brief Mean value, 0 if empty.
+        uint64_t mean() const { return count != 0 ? sum / count : 0; }
+    };
+
+    TCP_Stats();
+    ~TCP_Stats();
+
+    // Disable copying.
+    TCP_Stats(const TCP_Stats &) = delete;
+    TCP_Stats &operator=(const TCP_Stats &) = delete;
+
+    /**
+     * @brief Adds to a counter on the calling thread's shard.
+     * @param counter Counter index, below COUNTERS.
+     * @param delta Amount to add; may be negative.
+     */
+    void add(std::size_t counter, int64_t delta = 1);
+
+    /**
+     * @brief Records a value in a histogram on the calling thread's shard.
+     * @param histogram Histogram index, below HISTOGRAMS.
+     * @param value The value, e.g. a duration in nanoseconds.
+     */
+    void record(std::size_t histogram, uint64_t value);
+
+    /**
+     * @brief Sums a counter over all shards.
+     * @param counter Counter index.
+     * @return The total.
+     */
+    int64_t read(std::size_t counter) const;
+
+    /**
+     * @brief Sums a histogram over all shards.
+     * @param histogram Histogram index.
+     * @return The combined histogram.
+     */
+    Histogram histogram(std::size_t histogram) const;
+
+    /**
+     * @brief Counts the shards allocated so far.
+     * @return Roughly the peak number of threads that updated these stats.
+     */
+    std::size_t shards() const;
+
+private:
+    struct Shard;
+
+    /// @brief Identifies these stats to thread caches; never reused.
+    const uint64_t id_;
+
+    /// @brief All shards, newest first; freed by the destructor.
+    std::atomic<Shard *> shards_;
+
+    /// @brief Returns the calling thread's shard, claiming one on first use.
+    Shard &shard();
+
+    /// @brief Reuses a released shard or allocates a new one.
+    Shard *claim();
+
+    /// @brief Releases a thread's shards when it exits.
+    friend struct TCP_StatsThread;
+};
+
+#endif // TCP_STATS_HPP